@@ -0,0 +1,500 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hashTables.h"
+#include "concurrentHashTables.h"
+#include "mappedHashTable.h"
+#include "internedStrings.h"
+#include "lruCache.h"
+#include "perfectHash.h"
+
+// Замеры производительности собираются отдельно от tests.cpp (вместе с
+// main_test.cpp) и печатают результаты строками "[ BENCH    ]"
+
+// Задержки одиночных вставок: полный rehash против постепенного. Отдельно
+// считаются вставки, на которых менялась ёмкость, - при полном rehash
+// именно они делают всю работу, - и вставки, закончившие перенос: они
+// освобождают старый массив. Остальные выбросы на общей машине дают
+// в основном планировщик и первые обращения к новым страницам памяти
+template<typename Table>
+void reportInsertLatency(const char* name, size_t step, int n) {
+    Table table;
+    table.setIncrementalRehash(step);
+    std::vector<double> micros(n);
+    double worstGrowth = 0, worstFinish = 0;
+    for (int i = 0; i < n; ++i) {
+        size_t capacity = table.getCapacity();
+        bool rehashing = table.isRehashing();
+        auto start = std::chrono::steady_clock::now();
+        table.insert(i, i);
+        auto end = std::chrono::steady_clock::now();
+        micros[i] = std::chrono::duration<double, std::micro>(end - start).count();
+        if (table.getCapacity() != capacity) worstGrowth = std::max(worstGrowth, micros[i]);
+        else if (rehashing && !table.isRehashing()) worstFinish = std::max(worstFinish, micros[i]);
+    }
+    std::sort(micros.begin(), micros.end());
+    std::cout << "[ BENCH    ] " << name << (step ? " incremental" : " full") << ", " << n
+              << " inserts, us: growth insert max " << worstGrowth << ", migration end max " << worstFinish << ", p99.9 "
+              << micros[n - 1 - n / 1000] << ", p99.99 " << micros[n - 1 - n / 10000] << ", max "
+              << micros[n - 1] << std::endl;
+}
+
+TEST(IncrementalRehashTest, InsertLatencyBenchmark) {
+    for (int n : {1 << 16, 1 << 20, 1 << 22}) {
+        reportInsertLatency<ChainingHashTable<int, int>>("chaining", 0, n);
+        reportInsertLatency<ChainingHashTable<int, int>>("chaining", 8, n);
+        reportInsertLatency<OpenAddressingHashTable<int, int>>("OA", 0, n);
+        reportInsertLatency<OpenAddressingHashTable<int, int>>("OA", 8, n);
+    }
+}
+
+// Цена блокировки чтения: пары lock_shared/unlock_shared из threads потоков
+template<typename Mutex>
+double sharedLockMillis(int threads, int perThread) {
+    Mutex lock;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&lock, perThread]() {
+            for (int i = 0; i < perThread; ++i) {
+                std::shared_lock<Mutex> guard(lock);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(ReaderSlotsMutexTest, ReadLockBenchmark) {
+    const int perThread = 1 << 20;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (int threads : {1, 4, 16}) {
+        std::cout << "[ BENCH    ] " << threads << " readers x " << perThread << " read locks (" << cores
+                  << " cores): std::shared_mutex " << sharedLockMillis<std::shared_mutex>(threads, perThread)
+                  << " ms, ReaderSlotsMutex " << sharedLockMillis<ReaderSlotsMutex>(threads, perThread) << " ms"
+                  << std::endl;
+    }
+}
+
+// Пропускная способность на смеси с 2% записей: ConcurrentChainingHashTable
+// (сегменты под ReaderSlotsMutex) против одной ChainingHashTable под
+// одним мьютексом. Работа на поток постоянна, поэтому при линейном
+// масштабировании операций в секунду становится больше пропорционально
+// числу потоков
+template<typename Table>
+double readMostlyOpsPerSecond(Table& table, const std::vector<int>& keys, int threads, size_t perThread) {
+    double seconds = measureConcurrentTime(table, keys, threads, perThread, 50);
+    return seconds > 0 ? threads * static_cast<double>(perThread) / seconds : 0.0;
+}
+
+TEST(ConcurrentChainingTest, ReadMostlyScalingBenchmark) {
+    const int n = 1 << 16;
+    const size_t perThread = 1 << 18;
+    std::vector<int> keys;
+    for (int i = 0; i < n; ++i) keys.push_back(i * 7 + 1);
+    ConcurrentChainingHashTable<int, int> segmented(2 * n);
+    ShardedHashTable<int, int, ChainingHashTable<int, int>, DefaultHash<int>, ExclusiveMutex> locked(1, 2 * n);
+    for (int key : keys) {
+        segmented.insert(key, key);
+        locked.insert(key, key);
+    }
+
+    std::cout << "[ BENCH    ] read-mostly (2% writes), " << perThread << " ops per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads, Mops/s:" << std::endl;
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        double segmentedRate = readMostlyOpsPerSecond(segmented, keys, threads, perThread);
+        double lockedRate = readMostlyOpsPerSecond(locked, keys, threads, perThread);
+        std::cout << "[ BENCH    ]   " << std::setw(2) << threads << " threads: segmented "
+                  << segmentedRate / 1e6 << ", one mutex " << lockedRate / 1e6 << std::endl;
+    }
+    EXPECT_EQ(segmented.getSize(), static_cast<size_t>(n));
+    EXPECT_EQ(locked.getSize(), static_cast<size_t>(n));
+}
+
+// Счётчики <int, int> с 25% записей: неблокирующая AtomicHashTable
+// против таблицы с разнесёнными блокировками (64 шарда под мьютексами)
+// на одном наборе ключей
+TEST(AtomicHashTableTest, ThroughputVersusStripedBenchmark) {
+    const int n = 1 << 16;
+    const size_t perThread = 1 << 17;
+    std::vector<int> keys;
+    for (int i = 0; i < n; ++i) keys.push_back(i * 13 + 5);
+    AtomicHashTable<int, int> atomic(2 * n);
+    ShardedHashTable<int, int> striped(64, 2 * n / 64);
+    for (int key : keys) {
+        atomic.insert(key, key);
+        striped.insert(key, key);
+    }
+
+    std::cout << "[ BENCH    ] 25% writes, " << perThread << " ops per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads, Mops/s:" << std::endl;
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        double atomicSeconds = measureConcurrentTime(atomic, keys, threads, perThread, 4);
+        double stripedSeconds = measureConcurrentTime(striped, keys, threads, perThread, 4);
+        double ops = threads * static_cast<double>(perThread) / 1e6;
+        std::cout << "[ BENCH    ]   " << std::setw(2) << threads << " threads: atomic "
+                  << (atomicSeconds > 0 ? ops / atomicSeconds : 0.0) << ", striped "
+                  << (stripedSeconds > 0 ? ops / stripedSeconds : 0.0) << std::endl;
+    }
+    EXPECT_EQ(atomic.getSize(), static_cast<size_t>(n));
+    EXPECT_EQ(striped.getSize(), static_cast<size_t>(n));
+}
+
+TEST(StaticDispatchTest, DirectVersusVirtualFindBenchmark) {
+    // Таблица помещается в кеш, поэтому разница - это цена косвенного вызова
+    const int n = 1000;
+    RobinHoodHashTable<int, int> direct;
+    PolymorphicHashTable<RobinHoodHashTable<int, int>> erased;
+    std::vector<int> keys;
+    for (int i = 0; i < n; ++i) {
+        direct.insert(i, i);
+        erased.insert(i, i);
+        keys.push_back(i * 7 % n);
+    }
+
+    double directTime = direct.measureFindTime(keys, 1000);
+    const HashTable<int, int>& erasedBase = erased;
+    double virtualTime = erasedBase.measureFindTime(keys, 1000);
+    std::cout << "[ BENCH    ] find x" << n * 1000 << ": direct " << directTime
+              << " s, virtual " << virtualTime << " s" << std::endl;
+    EXPECT_GE(directTime, 0.0);
+    EXPECT_GE(virtualTime, 0.0);
+}
+
+template<typename Table>
+void benchmarkFindBatch(const char* name, Table& table, int n) {
+    std::vector<int> keys;
+    std::mt19937 gen(7);
+    for (int i = 0; i < n; ++i) keys.push_back(static_cast<int>(gen() % (2 * n)));
+    std::vector<const int*> values(keys.size());
+    const Table& view = table;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t scalarHits = 0;
+    for (int key : keys) scalarHits += view.lookup(key) != nullptr;
+    auto middle = std::chrono::steady_clock::now();
+    view.findBatch(keys.data(), keys.size(), values.data());
+    auto end = std::chrono::steady_clock::now();
+
+    size_t batchHits = 0;
+    for (const int* value : values) batchHits += value != nullptr;
+    EXPECT_EQ(scalarHits, batchHits);
+    std::cout << "[ BENCH    ] " << name << " " << n << " keys: scalar "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, batch "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+}
+
+TEST(FindBatchTest, ScalarVersusBatchBenchmark) {
+    const int n = 1 << 20;
+    ChainingHashTable<int, int> chain(n);
+    OpenAddressingHashTable<int, int> open(2 * n);
+    for (int i = 0; i < n; ++i) {
+        chain.insert(i, i);
+        open.insert(i, i);
+    }
+    benchmarkFindBatch("chaining", chain, n);
+    benchmarkFindBatch("open addressing", open, n);
+}
+
+TEST(MappedHashTableTest, StartupBenchmark) {
+    const std::string imageFile = "oa_bench.snap";
+    const int n = 200000;
+    {
+        OpenAddressingHashTable<int, int> table;
+        for (int i = 0; i < n; ++i) table.insert(i, i);
+        saveSnapshot(table, imageFile);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    OpenAddressingHashTable<int, int> rebuilt;
+    for (int i = 0; i < n; ++i) rebuilt.insert(i, i);
+    auto middle = std::chrono::steady_clock::now();
+    MappedHashTable<int, int> mapped(imageFile);
+    auto end = std::chrono::steady_clock::now();
+
+    int value = 0;
+    EXPECT_TRUE(mapped.find(n - 1, value));
+    EXPECT_EQ(value, n - 1);
+    std::cout << "[ BENCH    ] " << n << " entries: insert rebuild "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, mmap open "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    std::remove(imageFile.c_str());
+}
+
+TEST(IterationTest, SparseDumpBenchmark) {
+    // После массового удаления таблица почти пуста: карта пролетает пустые слова
+    const int n = 1 << 20;
+    OpenAddressingHashTable<int, int> table(2 * n);
+    for (int i = 0; i < n; ++i) table.insert(i, i);
+    for (int i = 0; i < n; ++i) {
+        if (i % 64) table.remove(i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    table.forEach([&](const int& key, const int&) { sum += key; });
+    auto end = std::chrono::steady_clock::now();
+
+    long long expected = 0;
+    for (int i = 0; i < n; i += 64) expected += i;
+    EXPECT_EQ(sum, expected);
+    std::cout << "[ BENCH    ] forEach over " << table.getCapacity() << " slots ("
+              << table.getSize() << " live): "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+}
+
+TEST(InternedStringsTest, MemoryAndLookupBenchmark) {
+    // 8 таблиц с одними и теми же 50000 ключами
+    const int keys = 50000, tables = 8;
+    std::vector<std::string> texts;
+    for (int i = 0; i < keys; ++i) texts.push_back("customer:" + std::to_string(1000000 + i) + ":region:eu-west");
+
+    std::vector<ChainingHashTable<std::string, int>> plain(tables);
+    std::vector<ChainingHashTable<InternedKey, int>> interned(tables);
+    StringInterner interner;
+    size_t plainBytes = 0, internedBytes = 0;
+    for (int t = 0; t < tables; ++t) {
+        for (int i = 0; i < keys; ++i) {
+            plain[t].insert(texts[i], i);
+            interned[t].insert(interner.intern(texts[i]), i);
+        }
+        // Текст ключа длиннее буфера короткой строки и лежит в куче
+        plainBytes += plain[t].memoryUsage() + keys * (texts[0].capacity() + 1);
+        internedBytes += interned[t].memoryUsage();
+    }
+    internedBytes += interner.memoryUsage();
+    EXPECT_LT(internedBytes, plainBytes / 2);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t plainHits = 0;
+    for (int round = 0; round < 4; ++round)
+        for (const auto& text : texts) plainHits += plain[round].lookup(text) != nullptr;
+    auto middle = std::chrono::steady_clock::now();
+    size_t internedHits = 0;
+    for (int round = 0; round < 4; ++round) {
+        for (const auto& text : texts) {
+            InternedKey key{0};
+            internedHits += interner.lookup(text, key) && interned[round].lookup(key) != nullptr;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_EQ(plainHits, internedHits);
+
+    // Ключ, интернированный один раз, дальше ищется как число
+    std::vector<InternedKey> handles;
+    for (const auto& text : texts) handles.push_back(interner.intern(text));
+    auto handleStart = std::chrono::steady_clock::now();
+    size_t handleHits = 0;
+    for (int round = 0; round < 4; ++round)
+        for (InternedKey key : handles) handleHits += interned[round].lookup(key) != nullptr;
+    auto handleEnd = std::chrono::steady_clock::now();
+    EXPECT_EQ(handleHits, plainHits);
+
+    std::cout << "[ BENCH    ] " << tables << " tables x " << keys << " keys: std::string "
+              << plainBytes / 1024 << " KiB, interned " << internedBytes / 1024 << " KiB; lookup string "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, text->handle "
+              << std::chrono::duration<double, std::milli>(end - middle).count() << " ms, by handle "
+              << std::chrono::duration<double, std::milli>(handleEnd - handleStart).count() << " ms" << std::endl;
+}
+
+TEST(BloomFilterTest, MissHeavyBenchmark) {
+    const int n = 1 << 19;
+    OpenAddressingHashTable<int, int> plain(n, 0.9), filtered(n, 0.9);
+    ChainingHashTable<int, int> chain(n / 4, 4.0), chainFiltered(n / 4, 4.0);
+    filtered.enableBloomFilter();
+    chainFiltered.enableBloomFilter();
+    for (int i = 0; i < n * 85 / 100; ++i) {
+        plain.insert(i, i);
+        filtered.insert(i, i);
+        chain.insert(i, i);
+        chainFiltered.insert(i, i);
+    }
+    // 95% промахов
+    std::vector<int> keys;
+    std::mt19937 gen(5);
+    for (int i = 0; i < n; ++i) keys.push_back(gen() % 20 == 0 ? static_cast<int>(gen() % (n / 2)) : n + static_cast<int>(gen() % n));
+
+    auto time = [&](const auto& table) {
+        size_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int key : keys) hits += table.lookup(key) != nullptr;
+        auto end = std::chrono::steady_clock::now();
+        return std::make_pair(hits, std::chrono::duration<double, std::milli>(end - start).count());
+    };
+    auto [plainHits, plainMs] = time(plain);
+    auto [filteredHits, filteredMs] = time(filtered);
+    auto [chainHits, chainMs] = time(chain);
+    auto [chainFilteredHits, chainFilteredMs] = time(chainFiltered);
+    EXPECT_EQ(plainHits, filteredHits);
+    EXPECT_EQ(chainHits, chainFilteredHits);
+    std::cout << "[ BENCH    ] 95% misses: OA " << plainMs << " ms, OA+bloom " << filteredMs
+              << " ms, chaining " << chainMs << " ms, chaining+bloom " << chainFilteredMs << " ms" << std::endl;
+}
+
+TEST(LruCacheTest, HitPathBenchmark) {
+    const int n = 1 << 16;
+    std::vector<int> keys;
+    std::mt19937 gen(3);
+    // Смещённое распределение: большая часть обращений к горячему набору
+    for (int i = 0; i < 1 << 21; ++i) keys.push_back(gen() % 4 ? static_cast<int>(gen() % (n / 2)) : static_cast<int>(gen() % (n * 2)));
+
+    for (EvictionPolicy policy : {EvictionPolicy::LRU, EvictionPolicy::CLOCK}) {
+        LruCache<int, int> cache(n, policy);
+        auto start = std::chrono::steady_clock::now();
+        for (int key : keys) {
+            if (!cache.get(key)) cache.put(key, key);
+        }
+        auto end = std::chrono::steady_clock::now();
+        EXPECT_LE(cache.size(), static_cast<size_t>(n));
+        std::cout << "[ BENCH    ] " << (policy == EvictionPolicy::LRU ? "LRU  " : "CLOCK") << " "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms, hit rate "
+                  << cache.hitRate() << std::endl;
+    }
+}
+
+TEST(PerfectHashTest, ReadOnlyBenchmark) {
+    const int n = 1 << 18;
+    std::vector<std::pair<int, int>> entries;
+    std::mt19937 gen(9);
+    OpenAddressingHashTable<int, int> open(n);
+    for (int i = 0; i < n; ++i) {
+        int key = static_cast<int>(gen());
+        if (open.lookup(key)) continue;
+        open.insert(key, i);
+        entries.emplace_back(key, i);
+    }
+    auto start = std::chrono::steady_clock::now();
+    PerfectHashTable<int, int> perfect(entries);
+    auto built = std::chrono::steady_clock::now();
+
+    std::vector<int> keys;
+    for (int i = 0; i < 1 << 21; ++i) keys.push_back(entries[gen() % entries.size()].first);
+    auto time = [&](const auto& table) {
+        size_t sum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int key : keys) sum += *table.lookup(key);
+        auto end = std::chrono::steady_clock::now();
+        return std::make_pair(sum, std::chrono::duration<double, std::milli>(end - begin).count());
+    };
+    auto [openSum, openMs] = time(open);
+    auto [perfectSum, perfectMs] = time(perfect);
+    EXPECT_EQ(openSum, perfectSum);
+    std::cout << "[ BENCH    ] " << entries.size() << " keys: build "
+              << std::chrono::duration<double, std::milli>(built - start).count() << " ms; hits: OA " << openMs
+              << " ms (" << open.getCapacity() << " slots), perfect " << perfectMs << " ms (" << perfect.getSize()
+              << " slots)" << std::endl;
+}
+
+TEST(InsertBulkTest, LoadBenchmark) {
+    const int n = 1 << 20;
+    std::vector<std::pair<int, int>> entries;
+    std::mt19937 gen(21);
+    for (int i = 0; i < n; ++i) entries.emplace_back(static_cast<int>(gen()), i);
+
+    auto time = [&](auto&& load) {
+        auto start = std::chrono::steady_clock::now();
+        load();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+    ChainingHashTable<int, int> chainLoop, chainBulk;
+    OpenAddressingHashTable<int, int> openLoop, openBulk;
+    double chainLoopMs = time([&] { for (const auto& [key, value] : entries) chainLoop.insert(key, value); });
+    double chainBulkMs = time([&] { chainBulk.insertBulk(entries.begin(), entries.end()); });
+    double openLoopMs = time([&] { for (const auto& [key, value] : entries) openLoop.insert(key, value); });
+    double openBulkMs = time([&] { openBulk.insertBulk(entries.begin(), entries.end()); });
+
+    EXPECT_EQ(chainLoop.getSize(), chainBulk.getSize());
+    EXPECT_EQ(openLoop.getSize(), openBulk.getSize());
+    EXPECT_EQ(chainBulk.stats().rehashCount, 1u);
+    EXPECT_EQ(openBulk.stats().rehashCount, 1u);
+    std::cout << "[ BENCH    ] " << n << " pairs: chaining insert " << chainLoopMs << " ms ("
+              << chainLoop.stats().rehashCount << " rehashes), insertBulk " << chainBulkMs << " ms; OA insert "
+              << openLoopMs << " ms (" << openLoop.stats().rehashCount << " rehashes), insertBulk " << openBulkMs
+              << " ms" << std::endl;
+}
+
+TEST(ParallelRehashTest, ScalingBenchmark) {
+    const int n = 1 << 21;
+    OpenAddressingHashTable<int, int> open(n * 2);
+    ChainingHashTable<int, int> chain(n * 2);
+    std::mt19937 gen(31);
+    for (int i = 0; i < n; ++i) {
+        int key = static_cast<int>(gen());
+        open.insert(key, i);
+        chain.insert(key, i);
+    }
+    size_t distinct = open.getSize();
+    std::cout << "[ BENCH    ] rehash of " << n << " entries, " << std::thread::hardware_concurrency()
+              << " hardware threads:" << std::endl;
+    for (size_t threads : {1, 2, 4, 8, 16, 32}) {
+        open.setRehashThreads(threads);
+        chain.setRehashThreads(threads);
+        auto start = std::chrono::steady_clock::now();
+        open.rehash(open.getCapacity() + 1);
+        auto middle = std::chrono::steady_clock::now();
+        chain.rehash(chain.getCapacity() + 1);
+        auto end = std::chrono::steady_clock::now();
+        EXPECT_EQ(open.getSize(), distinct);
+        EXPECT_EQ(chain.getSize(), distinct);
+        std::cout << "[ BENCH    ]   " << std::setw(2) << threads << " threads: OA "
+                  << std::chrono::duration<double, std::milli>(middle - start).count() << " ms, chaining "
+                  << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    }
+    int value = 0;
+    gen.seed(31);
+    for (int i = 0; i < n; ++i) {
+        int key = static_cast<int>(gen());
+        ASSERT_TRUE(open.find(key, value));
+        ASSERT_TRUE(chain.find(key, value));
+    }
+}
+
+// Задержки операций и цена их замера. Цель собирается без
+// HASHTABLE_LATENCY, поэтому таймеры ставятся вокруг вызовов явно - так
+// же, как их ставит в таблицу макрос
+TEST(LatencyHistogramTest, OperationLatencyBenchmark) {
+    OpenAddressingHashTable<int, int> table;
+    LatencyRecorder recorder;
+    const int n = 200000;
+    for (int i = 0; i < n; ++i) {
+        LatencyTimer timer(recorder, HashOp::INSERT);
+        table.insert(i, i);
+    }
+    int value = 0;
+    for (int i = 0; i < n; ++i) {
+        LatencyTimer timer(recorder, HashOp::FIND);
+        table.find(i * 2, value);
+    }
+    LatencyHistogram inserts = recorder.snapshot(HashOp::INSERT);
+    LatencyHistogram finds = recorder.snapshot(HashOp::FIND);
+    EXPECT_EQ(inserts.count(), static_cast<uint64_t>(n));
+    EXPECT_EQ(finds.count(), static_cast<uint64_t>(n));
+
+    double scale = cyclesPerNanosecond();
+    std::cout << "[ BENCH    ] latency, ns: insert p50 " << inserts.percentile(50) / scale << " p99 "
+              << inserts.percentile(99) / scale << " max " << inserts.maxValue() / scale << "; find p50 "
+              << finds.percentile(50) / scale << " p99 " << finds.percentile(99) / scale << std::endl;
+
+    // Цена замера: тот же поиск с таймером и без
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        LatencyTimer timer(recorder, HashOp::FIND);
+        hits += table.find(i, value);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) hits += table.find(i, value);
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_EQ(hits, static_cast<size_t>(2 * n));
+    std::cout << "[ BENCH    ] " << n << " finds: instrumented " << std::chrono::duration<double, std::milli>(middle - start).count()
+              << " ms, direct " << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+}
@@ -0,0 +1,688 @@
+#ifndef CONCURRENTHASHTABLES_H
+#define CONCURRENTHASHTABLES_H
+
+#include "hashTables.h"
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// ==========================================================
+// 1. БЛОКИРОВКА ЧТЕНИЯ-ЗАПИСИ С РАЗНЕСЁННЫМИ СЧЁТЧИКАМИ ЧИТАТЕЛЕЙ
+// ==========================================================
+// std::shared_mutex считает читателей в одном слове: каждый lock_shared -
+// атомарная запись в общую кеш-линию, и на многих ядрах чтения одного
+// сегмента упираются в её перекидывание между ядрами. Здесь у читателей
+// READER_SLOTS счётчиков, каждый на своей линии; поток всегда берёт один
+// и тот же (по номеру потока), так что чтение пишет только в свою линию.
+// Писатель поднимает флаг и ждёт, пока все счётчики опустеют, - запись
+// платит за обход счётчиков, чтение от числа потоков не зависит.
+//
+// Оптимистичное чтение без блокировки (seqlock) здесь не подходит: ключи
+// и значения - произвольные типы вроде std::string, и чтение под
+// конкурентной записью было бы гонкой, а rehash сегмента освобождает
+// массивы, по которым в этот момент мог бы идти читатель.
+
+class ReaderSlotsMutex {
+public:
+    static constexpr size_t READER_SLOTS = 16;
+
+private:
+    struct alignas(64) Counter {
+        std::atomic<uint32_t> readers{0};
+    };
+
+    std::array<Counter, READER_SLOTS> counters;
+    alignas(64) std::atomic<bool> writing{false};
+    std::mutex writers;
+
+    static size_t threadSlot() {
+        static std::atomic<size_t> nextSlot{0};
+        thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % READER_SLOTS;
+        return slot;
+    }
+
+public:
+    // Счётчик увеличивается до проверки флага, писатель ставит флаг до
+    // проверки счётчиков (оба seq_cst): кто-то из двоих обязательно увидит
+    // другого. Увидевший писателя читатель отступает и ждёт
+    void lock_shared() {
+        std::atomic<uint32_t>& readers = counters[threadSlot()].readers;
+        while (true) {
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            if (!writing.load(std::memory_order_seq_cst)) return;
+            readers.fetch_sub(1, std::memory_order_release);
+            while (writing.load(std::memory_order_acquire)) std::this_thread::yield();
+        }
+    }
+
+    void unlock_shared() { counters[threadSlot()].readers.fetch_sub(1, std::memory_order_release); }
+
+    void lock() {
+        writers.lock();
+        writing.store(true, std::memory_order_seq_cst);
+        for (auto& counter : counters) {
+            while (counter.readers.load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+        }
+    }
+
+    void unlock() {
+        writing.store(false, std::memory_order_release);
+        writers.unlock();
+    }
+};
+
+// ==========================================================
+// 2. ТАБЛИЦА ИЗ СЕГМЕНТОВ ПОД ОТДЕЛЬНЫМИ БЛОКИРОВКАМИ
+// ==========================================================
+// Таблица разбита на сегменты, каждый - обычная однопоточная таблица
+// Table под своей блокировкой Lock и на своих кеш-линиях. Сегмент
+// выбирается старшими битами хеша, внутри сегмента ячейка - младшими.
+// Запись блокирует только свой сегмент, а рост сегмента (rehash) не
+// останавливает остальные. Чтения берут lock_shared: с ReaderSlotsMutex
+// они не пишут в общие кеш-линии, с ExclusiveMutex - исключают друг друга.
+// Пакетные операции раскладывают ключи по сегментам и берут блокировку
+// каждого сегмента один раз.
+
+// Обычный мьютекс в роли Lock: чтение блокирует так же, как запись
+class ExclusiveMutex {
+    std::mutex mutex;
+
+public:
+    void lock() { mutex.lock(); }
+    bool try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+    void lock_shared() { mutex.lock(); }
+    bool try_lock_shared() { return mutex.try_lock(); }
+    void unlock_shared() { mutex.unlock(); }
+};
+
+template<typename K, typename V, typename Table, typename Lock, typename Hash>
+class SegmentedHashTable {
+private:
+    struct alignas(64) Segment {
+        mutable Lock lock;
+        Table table;
+
+        template<typename... TableArgs>
+        explicit Segment(const TableArgs&... args) : table(args...) {}
+    };
+
+    std::vector<std::unique_ptr<Segment>> segments;
+    Hash hasher;
+
+    template<typename Q>
+    size_t segmentIndex(const Q& key) const {
+        uint64_t h = hasher(key);
+        return (h >> 32) & (segments.size() - 1);
+    }
+
+    // Номера элементов, сгруппированные по сегментам (сортировка подсчётом):
+    // элементы сегмента s лежат в order[offsets[s] .. offsets[s + 1])
+    template<typename Item, typename KeyOf>
+    void groupBySegment(const Item* items, size_t count, KeyOf keyOf, std::vector<size_t>& order,
+                        std::vector<size_t>& offsets) const {
+        std::vector<size_t> segmentOf(count);
+        offsets.assign(segments.size() + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            segmentOf[i] = segmentIndex(keyOf(items[i]));
+            offsets[segmentOf[i] + 1]++;
+        }
+        for (size_t s = 0; s < segments.size(); ++s) offsets[s + 1] += offsets[s];
+        std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+        order.resize(count);
+        for (size_t i = 0; i < count; ++i) order[fill[segmentOf[i]]++] = i;
+    }
+
+protected:
+    // segmentCount округляется до степени двойки; tableArgs передаются
+    // конструктору каждой таблицы после её начальной ёмкости
+    template<typename... TableArgs>
+    SegmentedHashTable(size_t segmentCount, size_t initialCapacity, const Hash& hash, const TableArgs&... tableArgs)
+        : hasher(hash) {
+        size_t count = 1;
+        while (count < segmentCount) count <<= 1;
+        size_t perSegment = std::max<size_t>(2, initialCapacity / count);
+        for (size_t i = 0; i < count; ++i) segments.push_back(std::make_unique<Segment>(perSegment, tableArgs...));
+    }
+
+    // Заголовок "title (N units)", затем непустые сегменты под именем label
+    void displaySegments(const char* title, const char* units, const char* label) const {
+        std::cout << "\n" << title << " (" << segments.size() << " " << units << ")\n";
+        for (size_t i = 0; i < segments.size(); ++i) {
+            std::shared_lock<Lock> guard(segments[i]->lock);
+            if (segments[i]->table.getSize() == 0) continue;
+            std::cout << label << " " << i << ":";
+            segments[i]->table.display();
+        }
+    }
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+
+    void insert(const K& key, const V& value) {
+        Segment& segment = *segments[segmentIndex(key)];
+        std::unique_lock<Lock> guard(segment.lock);
+        segment.table.insert(key, value);
+    }
+
+    template<typename Q>
+    bool find(const Q& key, V& value) const {
+        const Segment& segment = *segments[segmentIndex(key)];
+        std::shared_lock<Lock> guard(segment.lock);
+        return segment.table.find(key, value);
+    }
+
+    template<typename Q>
+    bool remove(const Q& key) {
+        Segment& segment = *segments[segmentIndex(key)];
+        std::unique_lock<Lock> guard(segment.lock);
+        return segment.table.remove(key);
+    }
+
+    void insertBatch(const std::pair<K, V>* items, size_t count) {
+        std::vector<size_t> order, offsets;
+        groupBySegment(items, count, [](const std::pair<K, V>& item) -> const K& { return item.first; }, order,
+                       offsets);
+        for (size_t s = 0; s < segments.size(); ++s) {
+            if (offsets[s] == offsets[s + 1]) continue;
+            std::unique_lock<Lock> guard(segments[s]->lock);
+            for (size_t i = offsets[s]; i < offsets[s + 1]; ++i)
+                segments[s]->table.insert(items[order[i]].first, items[order[i]].second);
+        }
+    }
+
+    // found[i] - найден ли keys[i]; values[i] записывается только для
+    // найденных. Значения копируются под блокировкой: указатель внутрь
+    // сегмента, как у findBatch однопоточных таблиц, пережил бы её.
+    // Возвращает число найденных
+    size_t findBatch(const K* keys, size_t count, V* values, bool* found) const {
+        std::vector<size_t> order, offsets;
+        groupBySegment(keys, count, [](const K& key) -> const K& { return key; }, order, offsets);
+        size_t result = 0;
+        for (size_t s = 0; s < segments.size(); ++s) {
+            if (offsets[s] == offsets[s + 1]) continue;
+            std::shared_lock<Lock> guard(segments[s]->lock);
+            for (size_t i = offsets[s]; i < offsets[s + 1]; ++i) {
+                size_t index = order[i];
+                found[index] = segments[s]->table.find(keys[index], values[index]);
+                if (found[index]) result++;
+            }
+        }
+        return result;
+    }
+
+    size_t removeBatch(const K* keys, size_t count) {
+        std::vector<size_t> order, offsets;
+        groupBySegment(keys, count, [](const K& key) -> const K& { return key; }, order, offsets);
+        size_t result = 0;
+        for (size_t s = 0; s < segments.size(); ++s) {
+            if (offsets[s] == offsets[s + 1]) continue;
+            std::unique_lock<Lock> guard(segments[s]->lock);
+            for (size_t i = offsets[s]; i < offsets[s + 1]; ++i)
+                if (segments[s]->table.remove(keys[order[i]])) result++;
+        }
+        return result;
+    }
+
+    size_t getSize() const {
+        size_t result = 0;
+        for (const auto& segment : segments) {
+            std::shared_lock<Lock> guard(segment->lock);
+            result += segment->table.getSize();
+        }
+        return result;
+    }
+
+    size_t getCapacity() const {
+        size_t result = 0;
+        for (const auto& segment : segments) {
+            std::shared_lock<Lock> guard(segment->lock);
+            result += segment->table.getCapacity();
+        }
+        return result;
+    }
+
+    double loadFactor() const {
+        return static_cast<double>(getSize()) / getCapacity();
+    }
+
+    size_t getSegmentCount() const { return segments.size(); }
+
+    // Задержки операций всех сегментов вместе (см. HashTableBase::latencyHistogram).
+    // Время ожидания блокировки сегмента в них не входит
+    LatencyHistogram latencyHistogram(HashOp op) const {
+        LatencyHistogram result;
+        for (const auto& segment : segments) result.merge(segment->table.latencyHistogram(op));
+        return result;
+    }
+
+    void resetLatency() {
+        for (auto& segment : segments) {
+            std::unique_lock<Lock> guard(segment->lock);
+            segment->table.resetLatency();
+        }
+    }
+
+    size_t getSegmentSize(size_t segment) const {
+        std::shared_lock<Lock> guard(segments[segment]->lock);
+        return segments[segment]->table.getSize();
+    }
+};
+
+// Таблица цепочек под ReaderSlotsMutex: для нагрузки, где чтений
+// намного больше, чем записей
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class ConcurrentChainingHashTable
+    : public SegmentedHashTable<K, V, ChainingHashTable<K, V, Hash, KeyEqual>, ReaderSlotsMutex, Hash> {
+    using Base = SegmentedHashTable<K, V, ChainingHashTable<K, V, Hash, KeyEqual>, ReaderSlotsMutex, Hash>;
+
+public:
+    ConcurrentChainingHashTable(size_t initialCapacity = 1024, double loadFactor = 0.9, size_t segmentCount = 64,
+                                const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : Base(segmentCount, initialCapacity, hash, loadFactor, hash, keyEqual) {}
+
+    void display() const { this->displaySegments("ПОТОКОБЕЗОПАСНАЯ ХЕШ-ТАБЛИЦА", "сегментов", "Сегмент"); }
+};
+
+// ==========================================================
+// 3. НЕБЛОКИРУЮЩАЯ ТАБЛИЦА С ОТКРЫТОЙ АДРЕСАЦИЕЙ
+// ==========================================================
+// По мотивам таблицы Cliff Click и folly::AtomicHashArray. Ключи -
+// атомарные целые, линейное пробирование. Ячейка - ключ и слово
+// значения, в котором рядом со значением лежит двухбитный признак
+// состояния, так что любая смена значения - один CAS:
+//   ключ:     EMPTY -> ключ, навсегда (удалённый ключ остаётся в ячейке);
+//   значение: NONE      - значения ещё не было;
+//             LIVE(v)   - значение v;          TOMB - ключ удалён;
+//             PRIMED(v) - v заморожено и переносится в новый массив;
+//             DEAD      - ячейка перенесена, DEAD_EMPTY - закрыта пустой.
+// Признак занимает старшие 32 бита слова у целого значения или два
+// младших бита у указателя, поэтому значение - целое до 32 бит или
+// указатель, выровненный хотя бы на 4 байта.
+//
+// Ни одна операция не ждёт другого потока. find ничего не пишет, и число
+// его шагов ограничено длиной цепочки в каждом массиве, через который
+// идёт перенос. Запись lock-free: её CAS не проходит, только если слово
+// успел сменить другой поток.
+//
+// Рост - совместный: при переполнении рядом создаётся новый массив, и
+// каждая пишущая операция, заметившая его, переносит порцию из
+// MIGRATE_CHUNK ячеек, а перед записью - и ячейку своего ключа. Перенос
+// ячейки: CAS LIVE(v) -> PRIMED(v) замораживает значение, копия ложится
+// в новый массив, только если у ключа там ещё NONE, и CAS в DEAD
+// отправляет всех в новый массив. Запись, опередившая заморозку,
+// попадёт в копию; опоздавшая увидит PRIMED и повторится в новом
+// массиве - обновление не теряется. Копия, опоздавшая настолько, что
+// новый массив уже перенесён дальше, идёт за ним только через
+// DEAD_EMPTY: за DEAD ключ уже записан или удалён, и старое значение
+// его не воскресит. Ключ всегда занимается в старом массиве до записи в
+// новый, поэтому пустая ячейка на пути поиска - окончательный промах.
+// Удалённые ключи при переносе отбрасываются. Старые массивы
+// освобождаются в деструкторе или вызовом reclaim() в момент, когда
+// таблицей никто не пользуется.
+
+template<typename K, typename V, typename Hash = DefaultHash<K>>
+class AtomicHashTable {
+private:
+    static_assert(std::is_integral<K>::value, "AtomicHashTable: ключ должен быть целым");
+    static_assert((std::is_integral<V>::value && sizeof(V) <= 4) || std::is_pointer<V>::value,
+                  "AtomicHashTable: значение должно быть целым до 32 бит или указателем");
+
+    static constexpr size_t MIGRATE_CHUNK = 256;
+
+    // Признак состояния в слове значения
+    static constexpr uint64_t TAG_LIVE = 0;
+    static constexpr uint64_t TAG_PRIMED = 1;
+    static constexpr uint64_t TAG_ABSENT = 2;   // NONE или TOMB
+    static constexpr uint64_t TAG_DEAD = 3;     // DEAD или DEAD_EMPTY
+
+    static constexpr unsigned TAG_SHIFT = std::is_pointer<V>::value ? 0 : 32;
+    static constexpr uint64_t TAG_MASK = uint64_t(3) << TAG_SHIFT;
+    // Второй вариант служебного слова отличается младшим битом значения
+    static constexpr uint64_t VARIANT = std::is_pointer<V>::value ? 4 : 1;
+    static constexpr uint64_t NONE_WORD = TAG_ABSENT << TAG_SHIFT;
+    static constexpr uint64_t TOMB_WORD = NONE_WORD | VARIANT;
+    static constexpr uint64_t DEAD_WORD = TAG_DEAD << TAG_SHIFT;
+    static constexpr uint64_t DEAD_EMPTY_WORD = DEAD_WORD | VARIANT;
+
+    static uint64_t tagOf(uint64_t word) { return (word & TAG_MASK) >> TAG_SHIFT; }
+
+    static uint64_t pack(V value) {
+        if constexpr (std::is_pointer<V>::value) return reinterpret_cast<uintptr_t>(value);
+        else return static_cast<uint32_t>(value);
+    }
+
+    static V valueOf(uint64_t word) {
+        if constexpr (std::is_pointer<V>::value) return reinterpret_cast<V>(static_cast<uintptr_t>(word & ~TAG_MASK));
+        else return static_cast<V>(static_cast<uint32_t>(word));
+    }
+
+    struct Slot {
+        std::atomic<K> key;
+        std::atomic<uint64_t> word;
+    };
+
+    struct Array {
+        size_t capacity;   // степень двойки
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<size_t> claimed;   // ячейки, когда-либо занятые ключом
+        std::atomic<Array*> next;      // массив, в который идёт перенос
+        std::atomic<size_t> migrateCursor;
+        std::atomic<size_t> migrated;
+
+        Array(size_t cap, K emptyKey)
+            : capacity(cap), slots(new Slot[cap]), claimed(0), next(nullptr), migrateCursor(0), migrated(0) {
+            for (size_t i = 0; i < cap; ++i) {
+                slots[i].key.store(emptyKey, std::memory_order_relaxed);
+                slots[i].word.store(NONE_WORD, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Что делает store со словом значения
+    enum class Write {
+        INSERT,   // любое состояние -> LIVE(v)
+        COPY,     // NONE -> LIVE(v): копия при переносе
+        REMOVE    // LIVE -> TOMB
+    };
+
+    // Итог поиска в цепочке массивов
+    enum class Found { VALUE, DELETED, NOTHING };
+
+    std::atomic<Array*> root;
+    Array* oldest;   // начало цепочки массивов по полю next
+    std::atomic<size_t> count;
+    Hash hasher;
+    double maxLoad;
+    K emptyKey;
+
+    void startResize(Array* array) {
+        if (array->next.load(std::memory_order_acquire)) return;
+        // После переноса таблица заполнена примерно наполовину от maxLoad
+        size_t live = count.load(std::memory_order_relaxed) + 1;
+        size_t capacity = 16;
+        while (capacity * maxLoad < 2 * live) capacity <<= 1;
+
+        Array* fresh = new Array(capacity, emptyKey);
+        Array* expected = nullptr;
+        if (!array->next.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) delete fresh;
+    }
+
+    // Ячейка ключа в array или nullptr. С claim ключ занимает первую
+    // пустую ячейку цепочки. full - пустых ячеек на пути нет, и ключ,
+    // если он есть, лежит в следующем массиве
+    Slot* locate(Array* array, K key, size_t h, bool claim, bool& full) {
+        full = false;
+        size_t mask = array->capacity - 1;
+        for (size_t attempt = 0; attempt < array->capacity; ++attempt) {
+            Slot& slot = array->slots[(h + attempt) & mask];
+            K current = slot.key.load(std::memory_order_acquire);
+            if (current == emptyKey) {
+                if (!claim) return nullptr;
+                if (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                    size_t used = array->claimed.fetch_add(1, std::memory_order_relaxed) + 1;
+                    if (used > maxLoad * array->capacity) startResize(array);
+                    return &slot;
+                }
+                // Ячейку заняла другая вставка - возможно, того же ключа
+            }
+            if (current == key) return &slot;
+        }
+        full = true;
+        return nullptr;
+    }
+
+    // Переносит ячейку в array->next; по выходу её слово - DEAD или DEAD_EMPTY
+    void migrateSlot(Array* array, Slot& slot) {
+        uint64_t word = slot.word.load(std::memory_order_acquire);
+        while (tagOf(word) != TAG_PRIMED && tagOf(word) != TAG_DEAD) {
+            uint64_t frozen = tagOf(word) == TAG_LIVE ? word | (TAG_PRIMED << TAG_SHIFT)
+                              : word == NONE_WORD    ? DEAD_EMPTY_WORD
+                                                     : DEAD_WORD;
+            if (slot.word.compare_exchange_weak(word, frozen, std::memory_order_acq_rel)) word = frozen;
+        }
+        if (tagOf(word) == TAG_DEAD) return;
+        store(array->next.load(std::memory_order_acquire), slot.key.load(std::memory_order_acquire),
+              pack(valueOf(word)), Write::COPY);
+        // Не прошёл - ячейку уже закрыл другой переносчик
+        slot.word.compare_exchange_strong(word, DEAD_WORD, std::memory_order_acq_rel);
+    }
+
+    // Переносит очередную порцию ячеек; последняя порция переключает корень
+    void helpMigrate(Array* array) {
+        size_t start = array->migrateCursor.fetch_add(MIGRATE_CHUNK, std::memory_order_relaxed);
+        if (start >= array->capacity) return;
+        size_t end = std::min(start + MIGRATE_CHUNK, array->capacity);
+        for (size_t i = start; i < end; ++i) migrateSlot(array, array->slots[i]);
+
+        size_t done = array->migrated.fetch_add(end - start, std::memory_order_acq_rel) + (end - start);
+        if (done == array->capacity) {
+            Array* expected = array;
+            root.compare_exchange_strong(expected, array->next.load(std::memory_order_acquire),
+                                         std::memory_order_acq_rel);
+        }
+    }
+
+    // Пишет desired в слово ключа, начиная с array. Вставка и удаление
+    // пишут только в самый новый массив, предварительно перенеся туда
+    // ключ; копия пишет в тот массив, куда её направили. false - запись
+    // не понадобилась (ключа нет для remove, копию опередили)
+    bool store(Array* array, K key, uint64_t desired, Write mode) {
+        size_t h = hasher(key);
+        while (true) {
+            Array* next = array->next.load(std::memory_order_acquire);
+            if (next && mode != Write::COPY) helpMigrate(array);
+
+            bool full = false;
+            Slot* slot = locate(array, key, h, mode != Write::REMOVE, full);
+            if (!slot) {
+                if (!full) return false;   // remove: ключа нет
+                if (!next) {
+                    if (mode == Write::REMOVE) return false;
+                    startResize(array);
+                }
+                array = array->next.load(std::memory_order_acquire);
+                continue;
+            }
+            if (next && mode != Write::COPY) {
+                migrateSlot(array, *slot);
+                array = next;
+                continue;
+            }
+
+            uint64_t word = slot->word.load(std::memory_order_acquire);
+            while (tagOf(word) != TAG_PRIMED && tagOf(word) != TAG_DEAD) {
+                if (mode == Write::COPY && word != NONE_WORD) return false;
+                if (mode == Write::REMOVE && tagOf(word) != TAG_LIVE) return false;
+                if (slot->word.compare_exchange_weak(word, desired, std::memory_order_acq_rel)) {
+                    if (mode == Write::INSERT && tagOf(word) != TAG_LIVE) count.fetch_add(1, std::memory_order_relaxed);
+                    if (mode == Write::REMOVE) count.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            // Ячейку переносят: копия, у которой здесь уже было значение,
+            // не нужна; остальные продолжают в следующем массиве
+            if (mode == Write::COPY) {
+                if (word != DEAD_EMPTY_WORD) return false;
+            } else {
+                migrateSlot(array, *slot);
+            }
+            array = array->next.load(std::memory_order_acquire);
+        }
+    }
+
+    Found findFrom(Array* array, K key, size_t h, V& value) const {
+        for (; array; array = array->next.load(std::memory_order_acquire)) {
+            size_t mask = array->capacity - 1;
+            const Slot* slot = nullptr;
+            for (size_t attempt = 0; attempt < array->capacity; ++attempt) {
+                const Slot& candidate = array->slots[(h + attempt) & mask];
+                K current = candidate.key.load(std::memory_order_acquire);
+                if (current == emptyKey) return Found::NOTHING;
+                if (current == key) {
+                    slot = &candidate;
+                    break;
+                }
+            }
+            if (!slot) continue;   // массив полон: ключ мог лечь только дальше
+
+            uint64_t word = slot->word.load(std::memory_order_acquire);
+            switch (tagOf(word)) {
+            case TAG_LIVE:
+                value = valueOf(word);
+                return Found::VALUE;
+            case TAG_ABSENT:
+                return word == TOMB_WORD ? Found::DELETED : Found::NOTHING;
+            case TAG_PRIMED: {
+                // Пока копия не легла в новый массив, замороженное значение - текущее
+                Found later = findFrom(array->next.load(std::memory_order_acquire), key, h, value);
+                if (later != Found::NOTHING) return later;
+                value = valueOf(word);
+                return Found::VALUE;
+            }
+            default:
+                break;   // DEAD: ключ перенесён дальше
+            }
+        }
+        return Found::NOTHING;
+    }
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+
+    // Значение ключа reservedKey служебное и вставлено быть не может
+    AtomicHashTable(size_t initialCapacity = 1024, double loadFactor = 0.8, const Hash& hash = Hash(),
+                    K reservedKey = std::numeric_limits<K>::max())
+        : count(0), hasher(hash), maxLoad(loadFactor), emptyKey(reservedKey) {
+        size_t capacity = 16;
+        while (capacity < initialCapacity) capacity <<= 1;
+        oldest = new Array(capacity, emptyKey);
+        root.store(oldest, std::memory_order_relaxed);
+    }
+
+    ~AtomicHashTable() {
+        while (oldest) {
+            Array* next = oldest->next.load(std::memory_order_relaxed);
+            delete oldest;
+            oldest = next;
+        }
+    }
+
+    AtomicHashTable(const AtomicHashTable&) = delete;
+    AtomicHashTable& operator=(const AtomicHashTable&) = delete;
+
+    void insert(K key, V value) {
+        if (key == emptyKey) throw std::invalid_argument("AtomicHashTable: зарезервированное значение ключа");
+        if (pack(value) & TAG_MASK) throw std::invalid_argument("AtomicHashTable: указатель не выровнен на 4 байта");
+        store(root.load(std::memory_order_acquire), key, pack(value), Write::INSERT);
+    }
+
+    // Не ждёт других потоков и ничего не пишет
+    bool find(K key, V& value) const {
+        if (key == emptyKey) return false;
+        return findFrom(root.load(std::memory_order_acquire), key, hasher(key), value) == Found::VALUE;
+    }
+
+    bool remove(K key) {
+        if (key == emptyKey) return false;
+        return store(root.load(std::memory_order_acquire), key, TOMB_WORD, Write::REMOVE);
+    }
+
+    // Освобождает массивы, перенос из которых завершён. Безопасно только
+    // когда другие потоки не работают с таблицей
+    void reclaim() {
+        Array* current = root.load(std::memory_order_acquire);
+        while (oldest != current) {
+            Array* next = oldest->next.load(std::memory_order_relaxed);
+            delete oldest;
+            oldest = next;
+        }
+    }
+
+    size_t getSize() const { return count.load(std::memory_order_relaxed); }
+    size_t getCapacity() const { return root.load(std::memory_order_acquire)->capacity; }
+
+    double loadFactor() const {
+        return static_cast<double>(getSize()) / getCapacity();
+    }
+
+    void display() const {
+        std::cout << "\nНЕБЛОКИРУЮЩАЯ ХЕШ-ТАБЛИЦА\n";
+        for (Array* array = root.load(std::memory_order_acquire); array;
+             array = array->next.load(std::memory_order_acquire)) {
+            for (size_t i = 0; i < array->capacity; ++i) {
+                uint64_t word = array->slots[i].word.load(std::memory_order_acquire);
+                if (tagOf(word) != TAG_LIVE) continue;
+                std::cout << "Ячейка [" << i << "]: {" << array->slots[i].key.load(std::memory_order_acquire)
+                          << " = " << valueOf(word) << "}\n";
+            }
+        }
+    }
+};
+
+// ==========================================================
+// 4. ШАРДИРОВАННАЯ ОБЁРТКА НАД ЛЮБОЙ ХЕШ-ТАБЛИЦЕЙ
+// ==========================================================
+// SegmentedHashTable над таблицей любого типа; по умолчанию шард
+// закрыт обычным мьютексом (ExclusiveMutex), так что под записью
+// нет накладных расходов ReaderSlotsMutex. Число шардов по умолчанию -
+// по числу аппаратных потоков.
+
+template<typename K, typename V, typename Table = ChainingHashTable<K, V>, typename Hash = DefaultHash<K>,
+         typename Lock = ExclusiveMutex>
+class ShardedHashTable : public SegmentedHashTable<K, V, Table, Lock, Hash> {
+    using Base = SegmentedHashTable<K, V, Table, Lock, Hash>;
+
+public:
+    // shardCount = 0 - по числу аппаратных потоков; округляется до степени двойки
+    ShardedHashTable(size_t shardCount = 0, size_t initialCapacity = 1024, double loadFactor = 0.9,
+                     const Hash& hash = Hash())
+        : Base(shardCount ? shardCount : std::max(1u, std::thread::hardware_concurrency()), initialCapacity, hash,
+               loadFactor) {}
+
+    size_t getShardCount() const { return this->getSegmentCount(); }
+    size_t getShardSize(size_t shard) const { return this->getSegmentSize(shard); }
+
+    void display() const { this->displaySegments("ШАРДИРОВАННАЯ ХЕШ-ТАБЛИЦА", "шардов", "Шард"); }
+};
+
+// ==========================================================
+// ЗАМЕР ПРОПУСКНОЙ СПОСОБНОСТИ
+// ==========================================================
+// Время (в секундах), за которое threads потоков выполняют по
+// opsPerThread операций над ключами keys. Каждая writeEvery-я операция -
+// вставка, остальные - поиск; writeEvery = 0 - только поиск.
+
+template<typename Table, typename K>
+double measureConcurrentTime(Table& table, const std::vector<K>& keys, int threads,
+                             size_t opsPerThread, size_t writeEvery = 0) {
+    using V = typename Table::mapped_type;
+    std::vector<std::thread> workers;
+    auto start = high_resolution_clock::now();
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&table, &keys, t, opsPerThread, writeEvery]() {
+            V dummy{};
+            size_t index = static_cast<size_t>(t) * 7919 % keys.size();
+            for (size_t op = 0; op < opsPerThread; ++op) {
+                const K& key = keys[index];
+                if (writeEvery && op % writeEvery == 0) table.insert(key, V{});
+                else table.find(key, dummy);
+                if (++index == keys.size()) index = 0;
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    auto end = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(end - start);
+    return duration.count() / 1000000.0;
+}
+
+#endif
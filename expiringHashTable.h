@@ -0,0 +1,235 @@
+#ifndef EXPIRINGHASHTABLE_H
+#define EXPIRINGHASHTABLE_H
+
+#include "hashTables.h"
+#include <array>
+
+// ==========================================================
+// 1. ИЕРАРХИЧЕСКОЕ КОЛЕСО ТАЙМЕРОВ
+// ==========================================================
+// Время измеряется тиками; что такое тик (миллисекунда, секунда),
+// решает вызывающий, двигая часы через advance. Колесо - WHEEL_LEVELS
+// уровней по WHEEL_SLOTS ячеек: уровень 0 хранит таймеры ближайших 256
+// тиков по тику на ячейку, каждый следующий - в 256 раз более грубо.
+// Когда младшие разряды часов обнуляются, очередная ячейка верхнего
+// уровня раскладывается по уровням ниже. Таймер переносится не больше
+// WHEEL_LEVELS раз, а тик
+// обрабатывает только свою ячейку - O(1) амортизированно, без обхода
+// всей таблицы.
+
+constexpr size_t WHEEL_BITS = 8;
+constexpr size_t WHEEL_SLOTS = size_t(1) << WHEEL_BITS;
+constexpr size_t WHEEL_LEVELS = 4;
+constexpr uint64_t NEVER_EXPIRES = UINT64_MAX;
+
+template<typename K>
+class TimerWheel {
+public:
+    struct Timer {
+        K key;
+        uint64_t expiresAt;
+        uint64_t id;   // номер вставки: по нему опознаётся устаревший таймер
+    };
+
+private:
+    std::array<std::array<std::vector<Timer>, WHEEL_SLOTS>, WHEEL_LEVELS> slots;
+    std::vector<Timer> overflow;   // дальше горизонта колеса (2^32 тиков)
+    std::array<size_t, WHEEL_LEVELS + 1> levelCount{};   // таймеров на уровне, последний - overflow
+    uint64_t now = 0;
+    size_t count = 0;
+
+    void place(Timer&& timer) {
+        for (size_t level = 0; level < WHEEL_LEVELS; ++level) {
+            size_t shift = WHEEL_BITS * (level + 1);
+            // Таймер ложится на уровень, выше которого его срок совпадает с текущим
+            if ((timer.expiresAt >> shift) == (now >> shift)) {
+                slots[level][(timer.expiresAt >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1)].push_back(std::move(timer));
+                levelCount[level]++;
+                return;
+            }
+        }
+        overflow.push_back(std::move(timer));
+        levelCount[WHEEL_LEVELS]++;
+    }
+
+    // Заново раскладывает таймеры ячейки по уровням относительно now
+    void cascade(std::vector<Timer>& from, size_t level) {
+        std::vector<Timer> timers;
+        timers.swap(from);
+        levelCount[level] -= timers.size();
+        for (auto& timer : timers) place(std::move(timer));
+    }
+
+public:
+    uint64_t getNow() const { return now; }
+    size_t size() const { return count; }
+
+    // Срок уже наступивших таймеров переносится на следующий тик:
+    // ячейка текущего тика уже обработана
+    void schedule(const K& key, uint64_t expiresAt, uint64_t id) {
+        place(Timer{key, std::max(expiresAt, now + 1), id});
+        count++;
+    }
+
+    // Переводит часы на один тик и отдаёт fire(timer) все таймеры этого тика
+    template<typename F>
+    void tick(F fire) {
+        now++;
+        // Сначала верхние уровни: их таймеры могут попасть в ячейки ниже,
+        // которые раскладываются на этом же тике
+        if ((now & ((uint64_t(1) << (WHEEL_BITS * WHEEL_LEVELS)) - 1)) == 0) cascade(overflow, WHEEL_LEVELS);
+        for (size_t level = WHEEL_LEVELS - 1; level > 0; --level) {
+            uint64_t below = now & ((uint64_t(1) << (WHEEL_BITS * level)) - 1);
+            if (below == 0) cascade(slots[level][(now >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1)], level);
+        }
+        std::vector<Timer> due;
+        due.swap(slots[0][now & (WHEEL_SLOTS - 1)]);
+        count -= due.size();
+        levelCount[0] -= due.size();
+        for (auto& timer : due) fire(timer);
+    }
+
+    // Пропускает тики, на которых заведомо ничего не произойдёт, но не
+    // дальше moment - 1: если нижние уровни пусты, до ближайшей границы,
+    // где раскладывается ячейка первого непустого уровня. Без таймеров
+    // часы сразу встают на moment - 1
+    void skipIdle(uint64_t moment) {
+        size_t level = 0;
+        while (level <= WHEEL_LEVELS && levelCount[level] == 0) level++;
+        if (level == 0) return;
+        uint64_t next = moment - 1;
+        if (level <= WHEEL_LEVELS) {
+            uint64_t span = uint64_t(1) << (WHEEL_BITS * level);
+            next = std::min(next, (now | (span - 1)));
+        }
+        now = std::max(now, next);
+    }
+};
+
+// ==========================================================
+// 2. ТАБЛИЦА С ВРЕМЕНЕМ ЖИЗНИ ЗАПИСЕЙ
+// ==========================================================
+// Обёртка над ChainingHashTable или OpenAddressingHashTable со значением
+// ExpiringValue<V>. Запись с истёкшим сроком find считает отсутствующей
+// сразу, а физически её удаляет таймер на тике истечения. Перезапись и
+// remove не ищут старый таймер в колесе: он сработает впустую, увидев
+// другой номер вставки.
+
+template<typename V>
+struct ExpiringValue {
+    V value;
+    uint64_t expiresAt;
+    uint64_t id;
+};
+
+template<typename K, typename V, typename Table = ChainingHashTable<K, ExpiringValue<V>>>
+class ExpiringHashTable {
+private:
+    Table table;
+    TimerWheel<K> wheel;
+    uint64_t nextId = 0;
+    size_t expiredCount = 0;
+
+    bool alive(const ExpiringValue<V>& entry) const { return entry.expiresAt > wheel.getNow(); }
+
+public:
+    ExpiringHashTable() = default;
+    explicit ExpiringHashTable(Table initial) : table(std::move(initial)) {}
+
+    // Запись живёт ttl тиков от текущего момента; без ttl - бессрочно
+    void insert(const K& key, const V& value, uint64_t ttl) {
+        uint64_t current = wheel.getNow();
+        uint64_t expiresAt = ttl >= NEVER_EXPIRES - current ? NEVER_EXPIRES : current + ttl;
+        insertUntil(key, value, expiresAt);
+    }
+
+    void insert(const K& key, const V& value) { insertUntil(key, value, NEVER_EXPIRES); }
+
+    // Запись живёт до тика expiresAt (не включая его). Уже наступивший
+    // срок ничего не вставляет, а прежнее значение ключа удаляет
+    void insertUntil(const K& key, const V& value, uint64_t expiresAt) {
+        if (expiresAt <= wheel.getNow()) {
+            table.remove(key);
+            return;
+        }
+        uint64_t id = nextId++;
+        table.insertOrAssign(key, ExpiringValue<V>{value, expiresAt, id});
+        if (expiresAt != NEVER_EXPIRES) wheel.schedule(key, expiresAt, id);
+    }
+
+    const V* lookup(const K& key) const {
+        const ExpiringValue<V>* entry = table.lookup(key);
+        return entry && alive(*entry) ? &entry->value : nullptr;
+    }
+
+    bool find(const K& key, V& value) const {
+        const V* found = lookup(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    bool contains(const K& key) const { return lookup(key) != nullptr; }
+
+    // Истёкшая запись удаляется физически, но считается отсутствовавшей
+    bool remove(const K& key) {
+        const ExpiringValue<V>* entry = table.lookup(key);
+        if (!entry) return false;
+        bool wasAlive = alive(*entry);
+        table.remove(key);
+        return wasAlive;
+    }
+
+    // Оставшееся время жизни в тиках; NEVER_EXPIRES - бессрочная запись
+    bool timeToLive(const K& key, uint64_t& ticks) const {
+        const ExpiringValue<V>* entry = table.lookup(key);
+        if (!entry || !alive(*entry)) return false;
+        ticks = entry->expiresAt == NEVER_EXPIRES ? NEVER_EXPIRES : entry->expiresAt - wheel.getNow();
+        return true;
+    }
+
+    // Продвигает часы на ticks тиков и удаляет истёкшие записи.
+    // Возвращает число удалённых
+    size_t advance(uint64_t ticks = 1) {
+        size_t removed = 0;
+        uint64_t current = wheel.getNow();
+        uint64_t target = ticks >= NEVER_EXPIRES - current ? NEVER_EXPIRES - 1 : current + ticks;
+        while (wheel.getNow() < target) {
+            wheel.skipIdle(target);
+            wheel.tick([&](const typename TimerWheel<K>::Timer& timer) {
+                const ExpiringValue<V>* entry = table.lookup(timer.key);
+                if (entry && entry->id == timer.id) {
+                    table.remove(timer.key);
+                    removed++;
+                }
+            });
+        }
+        expiredCount += removed;
+        return removed;
+    }
+
+    // Обход живых записей: fn(key, value)
+    template<typename F>
+    void forEach(F fn) const {
+        table.forEach([&](const K& key, const ExpiringValue<V>& entry) {
+            if (alive(entry)) fn(key, entry.value);
+        });
+    }
+
+    uint64_t now() const { return wheel.getNow(); }
+
+    // Записи в таблице, включая истёкшие в текущем тике и ещё не удалённые
+    size_t getSize() const { return table.getSize(); }
+    size_t pendingTimers() const { return wheel.size(); }
+    size_t expired() const { return expiredCount; }
+
+    const Table& underlying() const { return table; }
+};
+
+template<typename K, typename V>
+using ExpiringChainingHashTable = ExpiringHashTable<K, V, ChainingHashTable<K, ExpiringValue<V>>>;
+
+template<typename K, typename V>
+using ExpiringOpenAddressingHashTable = ExpiringHashTable<K, V, OpenAddressingHashTable<K, ExpiringValue<V>>>;
+
+#endif
@@ -7,240 +7,2476 @@
 #include <functional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <iomanip>
 #include <chrono>   
 #include <random>    
 #include <algorithm> 
+#include <iterator>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+#include <limits>
+#include "latencyHistogram.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
 // ==========================================================
-// 1. БАЗОВЫЙ АБСТРАКТНЫЙ КЛАСС
+// 0. ХЕШ-ФУНКЦИИ ПО УМОЛЧАНИЮ
 // ==========================================================
-template<typename K, typename V>
-class HashTable {
+// std::hash для целых - тождественная функция, и последовательные ID
+// ложатся в соседние ячейки. DefaultHash перемешивает биты, а для строк
+// прозрачен (is_transparent): принимает std::string_view и const char*,
+// поэтому find/remove по ним не создают временную std::string.
+
+// Финализатор splitmix64: каждый бит входа влияет на все биты результата
+constexpr size_t mixHash(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+}
+
+template<typename K>
+struct DefaultHash {
+    size_t operator()(const K& key) const { return mixHash(std::hash<K>{}(key)); }
+};
+
+template<>
+struct DefaultHash<std::string> {
+    using is_transparent = void;
+    size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+};
+
+// Подсказка процессору заранее загрузить строку кеша с адресом p
+inline void prefetchRead(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#else
+    (void)p;
+#endif
+}
+
+// Размер группы ключей в findBatch: столько промахов кеша перекрываются
+constexpr size_t BATCH_GROUP = 16;
+
+// Число диапазонов ячеек, по которым insertBulk раскладывает записи
+constexpr size_t BULK_PARTITIONS = 4096;
+
+// Полный rehash таблицы меньше этого числа записей остаётся однопоточным:
+// запуск потоков обходится дороже самого переноса
+constexpr size_t PARALLEL_REHASH_MIN = 1 << 16;
+
+// Порог для ChainingHashTable выше: перевязка узла - одна запись в next
+// и одна в голову цепочки, дешевле вставки в открытую адресацию, и на
+// меньших пулах потоки и спор за головы цепочек её только замедляют
+constexpr size_t PARALLEL_RELINK_MIN = 1 << 20;
+
+// Делит [0, count) на threads почти равных диапазонов и вызывает
+// fn(begin, end) для каждого в своём потоке; последний диапазон
+// обрабатывает вызывающий поток
+template<typename F>
+void parallelRanges(size_t count, size_t threads, F fn) {
+    threads = std::max<size_t>(1, std::min(threads, count));
+    std::vector<std::thread> workers;
+    size_t chunk = count / threads, extra = count % threads, begin = 0;
+    for (size_t t = 0; t < threads; ++t) {
+        size_t end = begin + chunk + (t < extra ? 1 : 0);
+        if (t + 1 == threads) fn(begin, end);
+        else workers.emplace_back(fn, begin, end);
+        begin = end;
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+// Промежуточный буфер insertBulk: готовые хеши и итераторы на пары
+// источника, переставленные устойчивой сортировкой подсчётом по диапазону
+// домашней ячейки. Пары не копируются - вставка читает их из источника
+// по итератору, поэтому нужен многопроходный (прямой) итератор. Таблица
+// потом заполняется от начала к концу, а записи с одинаковым ключом
+// сохраняют порядок, в котором их передали
+template<typename H, typename It>
+struct BulkItem {
+    H hash;
+    It source;
+};
+
+template<typename H, typename It, typename HashFn, typename HomeFn>
+std::vector<BulkItem<H, It>> stageBulk(It first, It last, size_t capacity, HashFn hashOf, HomeFn homeOf) {
+    static_assert(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>,
+                  "insertBulk: диапазон читается несколько раз, нужен прямой итератор");
+    std::vector<H> hashes;
+    for (It it = first; it != last; ++it) hashes.push_back(hashOf(it->first));
+
+    size_t parts = std::min(capacity, BULK_PARTITIONS);
+    std::vector<size_t> start(parts + 1, 0);
+    for (H h : hashes) start[homeOf(h) * parts / capacity + 1]++;
+    for (size_t p = 0; p < parts; ++p) start[p + 1] += start[p];
+
+    std::vector<BulkItem<H, It>> staged(hashes.size());
+    size_t i = 0;
+    for (It it = first; it != last; ++it, ++i) {
+        H h = hashes[i];
+        staged[start[homeOf(h) * parts / capacity]++] = {h, it};
+    }
+    return staged;
+}
+
+// Разрешает перегрузки find/remove для ключей другого типа, только если
+// и хеш, и сравнение объявлены прозрачными
+template<typename Hash, typename KeyEqual>
+using TransparentKey = std::void_t<typename Hash::is_transparent, typename KeyEqual::is_transparent>;
+
+// Блочный фильтр Блума для быстрых промахов. Все биты ключа лежат в одном
+// 64-байтном блоке (по биту в каждом из 8 слов), так что проверка читает
+// одну кеш-линию. Фильтр работает с хешем, а не с номером ячейки, поэтому
+// переживает rehash таблицы без изменений. Удалить ключ из фильтра нельзя:
+// удалённые копятся как "устаревшие" и при их избытке фильтр перестраивается
+class BlockedBloomFilter {
+private:
+    struct alignas(64) Block {
+        uint64_t words[8];
+    };
+
+    std::vector<Block> blocks;
+    size_t bitsPerKey = 0;    // 0 - фильтр выключен
+    size_t keyCapacity = 0;   // на столько ключей рассчитан размер
+    size_t added = 0;
+    size_t stale = 0;
+
+    // Множители из split block Bloom filter (Parquet): разные биты в словах блока
+    static constexpr uint32_t SALT[8] = {0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+                                         0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u};
+
+    // Блок выбирается старшими 32 битами хеша (умножение вместо деления по модулю)
+    size_t blockIndex(uint64_t h) const { return ((h >> 32) * blocks.size()) >> 32; }
+    const Block& blockFor(uint64_t h) const { return blocks[blockIndex(h)]; }
+    Block& blockFor(uint64_t h) { return blocks[blockIndex(h)]; }
+
+public:
+    bool enabled() const { return bitsPerKey != 0; }
+
+    // Новый пустой фильтр на expectedKeys ключей
+    void reset(size_t expectedKeys, size_t bitsPerKeyValue) {
+        bitsPerKey = bitsPerKeyValue;
+        keyCapacity = std::max<size_t>(expectedKeys, 64);
+        blocks.assign((keyCapacity * bitsPerKey + 511) / 512, Block{});
+        added = 0;
+        stale = 0;
+    }
+
+    void disable() {
+        std::vector<Block>().swap(blocks);
+        bitsPerKey = keyCapacity = added = stale = 0;
+    }
+
+    void add(uint64_t h) {
+        Block& block = blockFor(h);
+        uint32_t low = static_cast<uint32_t>(h);
+        for (int i = 0; i < 8; ++i) block.words[i] |= 1ull << ((low * SALT[i]) >> 26);
+        added++;
+    }
+
+    // false - ключа с таким хешем точно нет
+    bool mayContain(uint64_t h) const {
+        const Block& block = blockFor(h);
+        uint32_t low = static_cast<uint32_t>(h);
+        for (int i = 0; i < 8; ++i) {
+            if (!(block.words[i] & (1ull << ((low * SALT[i]) >> 26)))) return false;
+        }
+        return true;
+    }
+
+    void noteRemoved() { stale++; }
+
+    // Переполнен (ложные срабатывания растут) или засорён удалёнными ключами
+    bool needsRebuild() const {
+        return enabled() && (added > keyCapacity || stale * 2 > added);
+    }
+
+    size_t getBitsPerKey() const { return bitsPerKey; }
+    size_t memoryUsage() const { return blocks.capacity() * sizeof(Block); }
+};
+
+// ==========================================================
+// 1. БАЗОВЫЙ КЛАСС (статический интерфейс, CRTP)
+// ==========================================================
+// Таблицы наследуются от HashTableBase<Derived, K, V> и объявлены final:
+// вызовы insert/find/remove идут напрямую, без vtable, и цикл пробирования
+// встраивается в вызывающий код (в том числе в measureFindTime).
+// Полиморфизм во время выполнения - по запросу, через PolymorphicHashTable.
+
+// Снимок структуры таблицы для настройки и периодического сбора метрик.
+// lengthHistogram[i] - для метода цепочек число ячеек с цепочкой длины i,
+// для открытой адресации - число ключей со смещением i от родной позиции
+// (0 - ключ на своём месте). Перекос гистограммы вправо - признак кластеров
+// из-за плохого распределения ключей или слабого хеша
+struct HashTableStats {
+    size_t size = 0;
+    size_t capacity = 0;
+    double loadFactor = 0.0;
+    std::vector<size_t> lengthHistogram;
+    size_t maxLength = 0;       // самая длинная цепочка или наибольшее смещение
+    size_t tombstones = 0;      // ячейки DELETED, которые удлиняют пробы
+    size_t rehashCount = 0;     // перестройки таблицы (рост, сжатие, rehash(n))
+    double rehashSeconds = 0.0; // суммарное время перестроек
+
+    void addLength(size_t length) {
+        if (length >= lengthHistogram.size()) lengthHistogram.resize(length + 1);
+        lengthHistogram[length]++;
+        maxLength = std::max(maxLength, length);
+    }
+
+    double averageLength() const {
+        size_t count = 0, total = 0;
+        for (size_t i = 0; i < lengthHistogram.size(); ++i) {
+            count += lengthHistogram[i];
+            total += i * lengthHistogram[i];
+        }
+        return count ? static_cast<double>(total) / count : 0.0;
+    }
+};
+
+// Замер операции таблицы; без HASHTABLE_LATENCY не порождает кода.
+// Макрос меняет только тела методов, а не раскладку таблиц, но, как и
+// NDEBUG, должен быть одинаковым во всех единицах трансляции программы
+#ifdef HASHTABLE_LATENCY
+#define HASHTABLE_TIMED(op) LatencyTimer latencyTimer(this->latency, op)
+#else
+#define HASHTABLE_TIMED(op) ((void)0)
+#endif
+
+template<typename Derived, typename K, typename V>
+class HashTableBase {
 protected:
     size_t capacity; 
     size_t size;
     double loadFactorThreshold;
+    double minLoadFactorThreshold;   // 0 - таблица не сжимается
+    size_t minCapacity;              // ниже начальной ёмкости автоматически не сжимаемся
+    size_t rehashCount;
+    steady_clock::duration rehashTime;
+
+    // Постепенный и параллельный rehash и фильтр Блума поддерживают
+    // ChainingHashTable и OpenAddressingHashTable; остальные таблицы
+    // этих полей не трогают
+    size_t rehashStep;      // ячеек за операцию при постепенном rehash, 0 - rehash целиком
+    size_t rehashThreads;   // потоков для полного rehash
+    BlockedBloomFilter bloom;   // необязательный фильтр промахов, по умолчанию выключен
+    mutable LatencyRecorder latency;   // пуст, пока операции не замеряются
+
+    // Верхняя граница порога роста. Цепочки растут без предела; таблицы
+    // с пробированием задают 1: ячеек в них не меньше, чем элементов, и
+    // при пороге выше 1 рост не наступил бы никогда - вставка в
+    // заполненную таблицу искала бы свободную ячейку бесконечно.
+    // Конструктор допускает ровно 1 (рост, когда таблица полна),
+    // setLoadFactors требует порог строго меньше
+    static constexpr double MAX_LOAD_LIMIT = std::numeric_limits<double>::infinity();
+
+    HashTableBase(size_t initialCapacity = 16, double loadFactor = 0.9)
+        : capacity(initialCapacity), size(0), loadFactorThreshold(loadFactor),
+          minLoadFactorThreshold(0.0), minCapacity(initialCapacity),
+          rehashCount(0), rehashTime(steady_clock::duration::zero()),
+          rehashStep(0), rehashThreads(1) {
+        if (!(loadFactor > 0 && loadFactor <= Derived::MAX_LOAD_LIMIT)) {
+            throw std::invalid_argument("HashTable: load factor out of range");
+        }
+    }
+
+    // Засекает одну перестройку таблицы: объявляется в начале resize
+    class RehashTimer {
+        HashTableBase& table;
+        steady_clock::time_point start;
+    public:
+        explicit RehashTimer(HashTableBase& owner) : table(owner), start(steady_clock::now()) {}
+        ~RehashTimer() {
+            table.rehashCount++;
+            table.rehashTime += steady_clock::now() - start;
+        }
+    };
+
+    // Общие поля stats(); гистограмму заполняет таблица
+    HashTableStats baseStats() const {
+        HashTableStats result;
+        result.size = size;
+        result.capacity = capacity;
+        result.loadFactor = loadFactor();
+        result.rehashCount = rehashCount;
+        result.rehashSeconds = duration<double>(rehashTime).count();
+        return result;
+    }
+
+    // Удаление через указатель на базу не предусмотрено - деструктор не виртуальный
+    ~HashTableBase() = default;
+
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    // Постепенный rehash раскладывает свою работу (перенос старой таблицы,
+    // подготовку следующей) по вставкам, оставшимся до следующего роста:
+    // доля work на одну операцию, при которой к росту всё будет сделано
+    size_t pacedStep(size_t work) const {
+        double limit = loadFactorThreshold * capacity;
+        size_t operations = limit > size + 1.0 ? static_cast<size_t>(limit - size) : 1;
+        return (work + operations - 1) / operations;
+    }
+
+    // Фильтр хранит перемешанный хеш ключа, поэтому перестройке не нужны
+    // сами ключи: таблица отдаёт сохранённые хеши через forEachHash
+    bool bloomAllows(uint64_t h) const { return !bloom.enabled() || bloom.mayContain(mixHash(h)); }
+
+    void rebuildBloom() {
+        bloom.reset(size * 2, bloom.getBitsPerKey());
+        derived().forEachHash([this](uint64_t h) { bloom.add(mixHash(h)); });
+    }
+
+    void bloomAdded(uint64_t h) {
+        if (!bloom.enabled()) return;
+        bloom.add(mixHash(h));
+        if (bloom.needsRebuild()) rebuildBloom();
+    }
+
+    void bloomRemoved() {
+        if (!bloom.enabled()) return;
+        bloom.noteRemoved();
+        if (bloom.needsRebuild()) rebuildBloom();
+    }
+
+    // Вызывается после удаления: заполненность ниже минимальной - таблица
+    // уменьшается вдвое. Минимальный порог меньше половины максимального,
+    // поэтому после сжатия таблица не упирается сразу в порог роста
+    void shrinkIfSparse() {
+        if (minLoadFactorThreshold > 0 && capacity > minCapacity && loadFactor() < minLoadFactorThreshold) {
+            derived().rehash(std::max(capacity / 2, minCapacity));
+        }
+    }
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+
+    double loadFactor() const {
+        return static_cast<double>(size) / capacity;
+    }
+
+    size_t getSize() const { return size; }
+    size_t getCapacity() const { return capacity; }
+
+    double maxLoadFactor() const { return loadFactorThreshold; }
+    double minLoadFactor() const { return minLoadFactorThreshold; }
+
+    // Пара порогов с гистерезисом: рост при заполненности maxLoad, сжатие
+    // вдвое ниже minLoad. minLoad = 0 отключает сжатие. Цепочки допускают
+    // maxLoad больше 1, таблицы с пробированием - только меньше 1
+    void setLoadFactors(double minLoad, double maxLoad) {
+        if (maxLoad <= 0 || minLoad < 0 || minLoad * 2 >= maxLoad) {
+            throw std::invalid_argument("setLoadFactors: need 0 <= 2 * minLoad < maxLoad");
+        }
+        if (maxLoad >= Derived::MAX_LOAD_LIMIT) {
+            throw std::invalid_argument("setLoadFactors: probing tables need maxLoad < 1");
+        }
+        minLoadFactorThreshold = minLoad;
+        loadFactorThreshold = maxLoad;
+    }
+
+    // Наименьшая ёмкость, в которую n элементов помещаются без роста
+    size_t capacityFor(size_t n) const {
+        return static_cast<size_t>(static_cast<double>(n) / loadFactorThreshold) + 1;
+    }
+
+    // Готовит место под n элементов: вставка до n элементов обходится без rehash
+    void reserve(size_t n) {
+        size_t needed = derived().capacityFor(n);
+        if (needed > capacity) derived().rehash(needed);
+    }
+
+    // Уменьшает ёмкость до наименьшей, вмещающей текущие элементы
+    void shrinkToFit() { derived().rehash(0); }
+
+    // Задержка insert включает rehash, если вставка его вызвала
+    void insert(const K& key, const V& value) {
+        HASHTABLE_TIMED(HashOp::INSERT);
+        derived().insertImpl(key, value);
+    }
+    bool find(const K& key, V& value) const {
+        HASHTABLE_TIMED(HashOp::FIND);
+        return derived().findImpl(key, value);
+    }
+    bool remove(const K& key) {
+        HASHTABLE_TIMED(HashOp::REMOVE);
+        return derived().removeImpl(key);
+    }
+
+    // Поиск без копирования значения: указатель на него или nullptr
+    // (Chaining, OpenAddressing, Cuckoo). Указатель действителен до
+    // следующей вставки, удаления или rehash
+    const V* lookup(const K& key) const {
+        HASHTABLE_TIMED(HashOp::FIND);
+        return derived().lookupImpl(key);
+    }
+    V* lookup(const K& key) {
+        HASHTABLE_TIMED(HashOp::FIND);
+        return const_cast<V*>(derived().lookupImpl(key));
+    }
+
+    // Прозрачный поиск и удаление по ключу другого типа (string_view, const char*)
+    template<typename Q, typename D = Derived, typename = TransparentKey<typename D::hash_type, typename D::key_equal_type>>
+    bool find(const Q& key, V& value) const {
+        HASHTABLE_TIMED(HashOp::FIND);
+        return derived().findImpl(key, value);
+    }
+    template<typename Q, typename D = Derived, typename = TransparentKey<typename D::hash_type, typename D::key_equal_type>>
+    bool remove(const Q& key) {
+        HASHTABLE_TIMED(HashOp::REMOVE);
+        return derived().removeImpl(key);
+    }
+    template<typename Q, typename D = Derived, typename = TransparentKey<typename D::hash_type, typename D::key_equal_type>>
+    const V* lookup(const Q& key) const {
+        HASHTABLE_TIMED(HashOp::FIND);
+        return derived().lookupImpl(key);
+    }
+    template<typename Q, typename D = Derived, typename = TransparentKey<typename D::hash_type, typename D::key_equal_type>>
+    V* lookup(const Q& key) {
+        HASHTABLE_TIMED(HashOp::FIND);
+        return const_cast<V*>(derived().lookupImpl(key));
+    }
+
+    // Распределение задержек insert, find/lookup и remove в тактах за всё
+    // время работы таблицы. Операции замеряются, только если программа
+    // собрана с HASHTABLE_LATENCY; иначе гистограммы пусты
+    LatencyHistogram latencyHistogram(HashOp op) const { return latency.snapshot(op); }
+    void resetLatency() { latency.reset(); }
+
+    // Пакетный поиск (Chaining, OpenAddressing): values[i] - указатель на
+    // значение keys[i] или nullptr. Выгоден на таблицах больше кеша, когда
+    // ключей много и они независимы
+    void findBatch(const K* keys, size_t count, const V** values) const { derived().findBatchImpl(keys, count, values); }
+    void findBatch(const K* keys, size_t count, V** values) { derived().findBatchImpl(keys, count, values); }
+
+    // Включает постепенный rehash (Chaining, OpenAddressing): при росте
+    // таблицы каждая вставка и удаление переносят не меньше step ячеек
+    // (больше, если иначе перенос не успеет до следующего роста). Массив
+    // следующего роста заполняется заранее теми же порциями, так что и
+    // сама растущая вставка не выделяет память под всю таблицу. Целиком
+    // по-прежнему делаются сжатие при удалении и перестройка фильтра Блума.
+    // 0 - выключить, незаконченный перенос при этом завершается сразу
+    void setIncrementalRehash(size_t step) {
+        if (step == 0) derived().completeRehash();
+        rehashStep = step;
+    }
+
+    // Потоков для полного rehash (рост, reserve, rehash) таблиц от
+    // PARALLEL_REHASH_MIN записей (у Chaining - от PARALLEL_RELINK_MIN);
+    // 0 - по числу ядер. Постепенный rehash
+    // остаётся однопоточным (Chaining, OpenAddressing)
+    void setRehashThreads(size_t threads) {
+        rehashThreads = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+    }
+    size_t getRehashThreads() const { return rehashThreads; }
+
+    // Фильтр Блума перед поиском (Chaining, OpenAddressing): промах
+    // отвечается по одной кеш-линии, без прохода по цепочке или пробам.
+    // bitsPerKey = 10 даёт около 1% ложных срабатываний. Фильтр растёт
+    // вместе с таблицей и перестраивается, когда удалённые ключи
+    // составляют больше половины добавленных
+    void enableBloomFilter(size_t bitsPerKey = 10) {
+        if (bitsPerKey == 0) throw std::invalid_argument("enableBloomFilter: bitsPerKey must be positive");
+        bloom.reset(0, bitsPerKey);
+        rebuildBloom();
+    }
+
+    void disableBloomFilter() { bloom.disable(); }
+    bool hasBloomFilter() const { return bloom.enabled(); }
+
+    // false - ключа точно нет; без фильтра всегда true
+    bool mightContain(const K& key) const { return bloomAllows(derived().hashOf(key)); }
+    
+    double measureFindTime(const vector<K>& keysToSearch, int m) const {
+        V dummy;
+        size_t hits = 0;
+        auto start = high_resolution_clock::now();
+        
+        for (int i = 0; i < m; i++) {
+            for (const auto& key : keysToSearch) {
+                hits += derived().find(key, dummy);
+            }
+        }
+        
+        auto end = high_resolution_clock::now();
+        // Результат нужен, иначе встроенный цикл поиска выбрасывается целиком
+        volatile size_t sink = hits;
+        (void)sink;
+        auto duration = duration_cast<microseconds>(end - start);
+        return duration.count() / 1000000.0;
+    }
+};
+
+// Абстрактный интерфейс для кода, которому тип таблицы известен только
+// во время выполнения. Каждый вызов - виртуальный.
+template<typename K, typename V>
+class HashTable {
+public:
+    virtual ~HashTable() {}
+
+    virtual void insert(const K& key, const V& value) = 0;
+    virtual bool find(const K& key, V& value) const = 0;
+    virtual bool remove(const K& key) = 0;
+    virtual void display() const = 0;
+
+    // Задержки операций конкретной таблицы (см. HashTableBase::latencyHistogram)
+    virtual LatencyHistogram latencyHistogram(HashOp op) const = 0;
+    virtual void resetLatency() = 0;
+
+    virtual size_t getSize() const = 0;
+    virtual size_t getCapacity() const = 0;
+
+    double loadFactor() const {
+        return static_cast<double>(getSize()) / getCapacity();
+    }
+
+    double measureFindTime(const vector<K>& keysToSearch, int m) const {
+        V dummy;
+        size_t hits = 0;
+        auto start = high_resolution_clock::now();
+        
+        for (int i = 0; i < m; i++) {
+            for (const auto& key : keysToSearch) {
+                hits += find(key, dummy);
+            }
+        }
+        
+        auto end = high_resolution_clock::now();
+        // Результат нужен, иначе встроенный цикл поиска выбрасывается целиком
+        volatile size_t sink = hits;
+        (void)sink;
+        auto duration = duration_cast<microseconds>(end - start);
+        return duration.count() / 1000000.0;
+    }
+};
+
+// Адаптер со стиранием типа: владеет конкретной таблицей и выставляет её
+// через HashTable<K, V>. Аргументы конструктора передаются таблице.
+template<typename Table>
+class PolymorphicHashTable final
+    : public HashTable<typename Table::key_type, typename Table::mapped_type> {
+private:
+    using K = typename Table::key_type;
+    using V = typename Table::mapped_type;
+
+    Table table;
+
+public:
+    template<typename... Args>
+    explicit PolymorphicHashTable(Args&&... args) : table(std::forward<Args>(args)...) {}
+
+    void insert(const K& key, const V& value) override { table.insert(key, value); }
+    bool find(const K& key, V& value) const override { return table.find(key, value); }
+    bool remove(const K& key) override { return table.remove(key); }
+    void display() const override { table.display(); }
+
+    LatencyHistogram latencyHistogram(HashOp op) const override { return table.latencyHistogram(op); }
+    void resetLatency() override { table.resetLatency(); }
+
+    size_t getSize() const override { return table.getSize(); }
+    size_t getCapacity() const override { return table.getCapacity(); }
+
+    Table& get() { return table; }
+    const Table& get() const { return table; }
+};
+
+// operator-> итератора, который разыменуется в прокси-значение: прокси
+// хранится внутри, и it->first обращается к его полям
+template<typename Reference>
+struct ArrowProxy {
+    Reference ref;
+    const Reference* operator->() const { return &ref; }
+};
+
+// Пул узлов страницами по PAGE элементов, индекс - номер страницы и
+// смещение в ней. Рост выделяет одну новую страницу и не переносит уже
+// созданные элементы, поэтому стоимость вставки не зависит от размера
+// пула. Только первая страница растёт как вектор, пока не станет полной:
+// маленькие таблицы не платят за целую страницу
+template<typename T>
+class PagedPool {
+    static constexpr unsigned PAGE_BITS = 12;
+    static constexpr size_t PAGE = size_t(1) << PAGE_BITS;
+
+    std::vector<std::vector<T>> pages;
+    size_t count = 0;
+
+    void addPage() {
+        pages.emplace_back();
+        if (pages.size() > 1) pages.back().reserve(PAGE);
+    }
+
+public:
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t i) { return pages[i >> PAGE_BITS][i & (PAGE - 1)]; }
+    const T& operator[](size_t i) const { return pages[i >> PAGE_BITS][i & (PAGE - 1)]; }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        size_t page = count >> PAGE_BITS;
+        if (page == pages.size()) addPage();
+        pages[page].emplace_back(std::forward<Args>(args)...);
+        count++;
+    }
+
+    // Одна пустая страница за последней остаётся про запас: вставка и
+    // удаление на границе страниц не выделяют память каждый раз
+    void pop_back() {
+        count--;
+        pages[count >> PAGE_BITS].pop_back();
+        if (pages.size() > (count >> PAGE_BITS) + 2) pages.pop_back();
+    }
+
+    void reserve(size_t n) {
+        while (pages.size() * PAGE < n) addPage();
+        if (!pages.empty()) pages.front().reserve(std::min(n, PAGE));
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const auto& page : pages) total += page.capacity();
+        return total;
+    }
+
+    size_t memoryUsage() const { return capacity() * sizeof(T) + pages.capacity() * sizeof(std::vector<T>); }
+
+    template<typename F>
+    void forEach(F fn) {
+        for (auto& page : pages) {
+            for (auto& item : page) fn(item);
+        }
+    }
+    template<typename F>
+    void forEach(F fn) const {
+        for (const auto& page : pages) {
+            for (const auto& item : page) fn(item);
+        }
+    }
+};
+
+// ==========================================================
+// 2. ХЕШ-ТАБЛИЦА: МЕТОД ЦЕПОЧЕК (Chaining)
+// ==========================================================
+
+// Цепочки хранятся не в std::list, а в страничном пуле узлов: у каждой
+// ячейки - 32-битный индекс первого узла, у узла - индекс следующего.
+// Пул всегда плотный (удалённый узел замещается последним), поэтому
+// rehash лишь перевязывает индексы, не копируя пары ключ-значение.
+
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class ChainingHashTable final : public HashTableBase<ChainingHashTable<K, V, Hash, KeyEqual>, K, V> {
+    using Base = HashTableBase<ChainingHashTable, K, V>;
+    friend Base;
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        K key;
+        V value;
+        uint32_t hash;   // хеш ключа: сравнивается до ключа, rehash его не пересчитывает
+        uint32_t next;
+
+        // Ключ и значение создаются прямо в пуле, без промежуточных копий
+        template<typename KK, typename... Args>
+        Node(uint32_t h, uint32_t n, KK&& k, Args&&... args)
+            : key(std::forward<KK>(k)), value(std::forward<Args>(args)...), hash(h), next(n) {}
+    };
+
+    PagedPool<Node> nodes;
+    std::vector<uint32_t> heads;
+    Hash hasher;
+    KeyEqual equal;
+
+    // Постепенный rehash: пока oldHeads не пуст, ячейки старой таблицы
+    // с номерами от migrateIndex ещё не перенесены в heads
+    std::vector<uint32_t> oldHeads;
+    size_t migrateIndex = 0;
+
+    // Массив голов для следующего роста: с 3/4 порога каждая вставка
+    // дописывает в него часть ячеек, и рост лишь меняет массивы местами
+    std::vector<uint32_t> preparedHeads;
+    size_t preparedFrom = 0;   // ёмкость, рост из которой готовится
+
+    // Счётчики для stats(), которые ведут вставка, удаление и перенос:
+    // chainCounts[i] - число ячеек heads и ещё не перенесённой части
+    // oldHeads с цепочкой длины i
+    std::vector<size_t> chainCounts;
+
+    size_t chainLength(uint32_t index) const {
+        size_t length = 0;
+        for (; index != NIL; index = nodes[index].next) ++length;
+        return length;
+    }
+
+    void countChain(size_t from, size_t to) {
+        chainCounts[from]--;
+        if (to >= chainCounts.size()) chainCounts.resize(to + 1, 0);
+        chainCounts[to]++;
+    }
+
+    // Пересчёт после полной перестройки: длины цепочек набираются одним
+    // последовательным проходом по пулу, без обхода цепочек
+    void recountChains() {
+        std::vector<uint32_t> lengths(heads.size(), 0);
+        for (uint32_t i = 0; i < nodes.size(); ++i) lengths[bucket(nodes[i].hash)]++;
+        chainCounts.assign(1, 0);
+        for (uint32_t length : lengths) {
+            if (length >= chainCounts.size()) chainCounts.resize(length + 1, 0);
+            chainCounts[length]++;
+        }
+    }
+
+    // Пул адресуется 32-битными индексами, поэтому и ячеек не больше 2^32 -
+    // младших 32 бит хеша хватает, а узел <int, int> укладывается в 16 байт
+    template<typename Q>
+    uint32_t hashOf(const Q& key) const {
+        return static_cast<uint32_t>(hasher(key));
+    }
+
+    size_t bucket(uint32_t h) const {
+        return h % this->capacity;
+    }
+
+    // Голова цепочки, в которой сейчас живёт ключ с хешем h: старая
+    // ячейка, если она ещё не перенесена, иначе новая
+    uint32_t* headFor(uint32_t h) {
+        if (!oldHeads.empty()) {
+            size_t oldIndex = h % oldHeads.size();
+            if (oldIndex >= migrateIndex) return &oldHeads[oldIndex];
+        }
+        return &heads[bucket(h)];
+    }
+
+    uint32_t headOf(uint32_t h) const {
+        if (!oldHeads.empty()) {
+            size_t oldIndex = h % oldHeads.size();
+            if (oldIndex >= migrateIndex) return oldHeads[oldIndex];
+        }
+        return heads[bucket(h)];
+    }
+
+    // Ссылка (голова ячейки или поле next), указывающая на узел с ключом key,
+    // либо ссылка со значением NIL в конце цепочки
+    template<typename Q>
+    uint32_t* findLink(const Q& key, uint32_t h) {
+        uint32_t* link = headFor(h);
+        while (*link != NIL && !(nodes[*link].hash == h && equal(nodes[*link].key, key))) link = &nodes[*link].next;
+        return link;
+    }
+
+    template<typename Q>
+    uint32_t findNode(const Q& key, uint32_t h) const {
+        uint32_t index = headOf(h);
+        while (index != NIL && !(nodes[index].hash == h && equal(nodes[index].key, key))) index = nodes[index].next;
+        return index;
+    }
+
+    template<typename F>
+    void forEachHash(F fn) const {
+        nodes.forEach([&](const Node& node) { fn(node.hash); });
+    }
+
+    template<typename Q>
+    const V* lookupImpl(const Q& key) const {
+        uint32_t h = hashOf(key);
+        if (!this->bloomAllows(h)) return nullptr;
+        uint32_t index = findNode(key, h);
+        return index == NIL ? nullptr : &nodes[index].value;
+    }
+
+    template<typename Q>
+    bool findImpl(const Q& key, V& value) const {
+        const V* found = lookupImpl(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    // Групповая предвыборка: сначала хеши всех ключей группы и загрузка их
+    // голов, затем загрузка первых узлов цепочек, и только потом сравнение.
+    // Промахи кеша разных ключей идут параллельно, а не друг за другом
+    template<typename Ptr>
+    void findBatchImpl(const K* keys, size_t count, Ptr* values) const {
+        uint32_t hashes[BATCH_GROUP];
+        uint32_t first[BATCH_GROUP];
+        for (size_t start = 0; start < count; start += BATCH_GROUP) {
+            size_t n = std::min(BATCH_GROUP, count - start);
+            for (size_t i = 0; i < n; ++i) {
+                hashes[i] = hashOf(keys[start + i]);
+                prefetchRead(&heads[bucket(hashes[i])]);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                first[i] = headOf(hashes[i]);
+                if (first[i] != NIL) prefetchRead(&nodes[first[i]]);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                uint32_t index = first[i];
+                const K& key = keys[start + i];
+                while (index != NIL && !(nodes[index].hash == hashes[i] && equal(nodes[index].key, key))) {
+                    index = nodes[index].next;
+                }
+                values[start + i] = index == NIL ? nullptr : const_cast<Ptr>(&nodes[index].value);
+            }
+        }
+    }
+
+    // Индекс узла с ключом key и признак того, что узел только что создан
+    // из args (существующий узел не трогается)
+    template<typename KK, typename... Args>
+    std::pair<uint32_t, bool> emplaceImpl(KK&& key, Args&&... args) {
+        if (this->loadFactor() >= this->loadFactorThreshold) resize(this->capacity * 2);
+        else migrateStep();
+        return emplaceHashed(hashOf(key), std::forward<KK>(key), std::forward<Args>(args)...);
+    }
+
+    // То же без проверки заполненности, по уже посчитанному хешу
+    template<typename KK, typename... Args>
+    std::pair<uint32_t, bool> emplaceHashed(uint32_t h, KK&& key, Args&&... args) {
+        uint32_t* link = findLink(key, h);
+        if (*link != NIL) return {*link, false};
+        if (nodes.size() >= NIL) throw std::length_error("ChainingHashTable: слишком много элементов");
+
+        // Узел ставится в ту цепочку, где его будет искать find: в старую,
+        // если ячейка ещё не перенесена, и переедет вместе с ней. Цепочка
+        // только что пройдена findLink, и её длина считается по кешу
+        uint32_t* head = headFor(h);
+        size_t length = chainLength(*head);
+        nodes.emplace_back(h, *head, std::forward<KK>(key), std::forward<Args>(args)...);
+        *head = static_cast<uint32_t>(nodes.size() - 1);
+        countChain(length, length + 1);
+        this->size++;
+        this->bloomAdded(h);
+        return {static_cast<uint32_t>(nodes.size() - 1), true};
+    }
+
+    void insertImpl(const K& key, const V& value) { insertOrAssign(key, value); }
+
+    template<typename Q>
+    bool removeImpl(const Q& key) {
+        migrateStep();
+        uint32_t h = hashOf(key);
+        if (!this->bloomAllows(h)) return false;
+        uint32_t* link = findLink(key, h);
+        uint32_t removed = *link;
+        if (removed == NIL) return false;
+        size_t length = chainLength(*headFor(h));
+        countChain(length, length - 1);
+        *link = nodes[removed].next;
+
+        // Закрываем дыру последним узлом пула и перевязываем ссылку на него
+        uint32_t last = static_cast<uint32_t>(nodes.size() - 1);
+        if (removed != last) {
+            uint32_t* lastLink = headFor(nodes[last].hash);
+            while (*lastLink != last) lastLink = &nodes[*lastLink].next;
+            *lastLink = removed;
+            nodes[removed] = std::move(nodes[last]);
+        }
+        nodes.pop_back();
+        this->size--;
+        this->bloomRemoved();
+        this->shrinkIfSparse();
+        return true;
+    }
+
+    // Переносит не больше count ячеек старой таблицы в новую
+    void migrateBuckets(size_t count) {
+        for (; count > 0 && migrateIndex < oldHeads.size(); --count, ++migrateIndex) {
+            uint32_t index = oldHeads[migrateIndex];
+            size_t moved = 0;
+            while (index != NIL) {
+                uint32_t next = nodes[index].next;
+                uint32_t& head = heads[bucket(nodes[index].hash)];
+                size_t length = chainLength(head);
+                countChain(length, length + 1);
+                nodes[index].next = head;
+                head = index;
+                index = next;
+                ++moved;
+            }
+            chainCounts[moved]--;
+        }
+        if (migrateIndex == oldHeads.size()) {
+            std::vector<uint32_t>().swap(oldHeads);
+            migrateIndex = 0;
+        }
+    }
+
+    void prepareStep() {
+        if (this->loadFactor() < this->loadFactorThreshold * 0.75) return;
+        size_t target = this->capacity * 2;
+        if (preparedFrom != this->capacity) {
+            std::vector<uint32_t>().swap(preparedHeads);
+            preparedHeads.reserve(target);
+            preparedFrom = this->capacity;
+        }
+        size_t missing = target - preparedHeads.size();
+        if (missing > 0) preparedHeads.insert(preparedHeads.end(), this->pacedStep(missing), NIL);
+    }
+
+    void releasePrepared() {
+        std::vector<uint32_t>().swap(preparedHeads);
+        preparedFrom = 0;
+    }
+
+    // Работа постепенного rehash на одну операцию: перенос не меньше
+    // rehashStep ячеек и подготовка следующего массива, обе в темпе,
+    // который успевает к следующему росту
+    void migrateStep() {
+        if (this->rehashStep == 0) return;
+        if (!oldHeads.empty()) {
+            migrateBuckets(std::max(this->rehashStep, this->pacedStep(oldHeads.size() - migrateIndex)));
+        }
+        prepareStep();
+    }
+
+    void completeRehash() {
+        if (!oldHeads.empty()) migrateBuckets(oldHeads.size());
+        releasePrepared();
+    }
+
+    // Перестраивает таблицу под newCapacity ячеек - и при росте, и при сжатии
+    void resize(size_t newCapacity) {
+        typename Base::RehashTimer timer(*this);
+        if (!oldHeads.empty()) migrateBuckets(oldHeads.size());
+
+        if (this->rehashStep > 0) {
+            // Старые цепочки остаются на месте и переносятся порциями;
+            // новый массив обычно уже подготовлен prepareStep
+            oldHeads = std::move(heads);
+            if (preparedFrom == this->capacity && preparedHeads.size() == newCapacity) {
+                heads = std::move(preparedHeads);
+            } else {
+                heads.assign(newCapacity, NIL);
+            }
+            releasePrepared();
+            this->capacity = newCapacity;
+            chainCounts[0] += newCapacity;
+            migrateIndex = 0;
+            migrateStep();
+            return;
+        }
+
+        heads.assign(newCapacity, NIL);
+        this->capacity = newCapacity;
+
+        if (this->rehashThreads > 1 && nodes.size() >= PARALLEL_RELINK_MIN) {
+            relinkParallel();
+        } else {
+            for (uint32_t i = 0; i < nodes.size(); ++i) {
+                size_t index = bucket(nodes[i].hash);
+                nodes[i].next = heads[index];
+                heads[index] = i;
+            }
+        }
+        recountChains();
+    }
+
+    // Параллельная перевязка: каждый поток берёт свой диапазон пула и
+    // ставит узлы в голову цепочки через compare-and-swap. Поле next узла
+    // пишет только его поток, так что гонка возможна лишь за голову ячейки.
+    // Порядок узлов в цепочке при этом зависит от расписания потоков
+    void relinkParallel() {
+        size_t count = this->capacity;
+        std::unique_ptr<std::atomic<uint32_t>[]> shared(new std::atomic<uint32_t>[count]);
+        parallelRanges(count, this->rehashThreads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) shared[i].store(NIL, std::memory_order_relaxed);
+        });
+        // Порядок памяти не нужен: цепочки читаются только после join
+        parallelRanges(nodes.size(), this->rehashThreads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                std::atomic<uint32_t>& head = shared[bucket(nodes[i].hash)];
+                uint32_t next = head.load(std::memory_order_relaxed);
+                do {
+                    nodes[i].next = next;
+                } while (!head.compare_exchange_weak(next, static_cast<uint32_t>(i), std::memory_order_relaxed));
+            }
+        });
+        parallelRanges(count, this->rehashThreads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) heads[i] = shared[i].load(std::memory_order_relaxed);
+        });
+    }
+
+public:
+    using hash_type = Hash;
+    using key_equal_type = KeyEqual;
+
+    ChainingHashTable(size_t initialCapacity = 16, double loadFactor = 0.9,
+                      const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : Base(initialCapacity, loadFactor), heads(initialCapacity, NIL),
+          hasher(hash), equal(keyEqual), chainCounts(1, initialCapacity) {}
+
+    bool isRehashing() const { return !oldHeads.empty(); }
+
+    // Задаёт число ячеек, но не меньше нужного для текущих элементов.
+    // В режиме постепенного rehash перенос идёт порциями, как и при росте
+    void rehash(size_t newCapacity) {
+        resize(std::max(newCapacity, this->capacityFor(this->size)));
+    }
+
+    // Пакетная загрузка пар (first - ключ, second - значение) из диапазона
+    // прямых итераторов. Ёмкость выделяется один раз, хеши считаются
+    // отдельным проходом, а узлы добавляются в порядке ячеек. Повторный
+    // ключ заменяет значение, как insert. Возвращает число новых ключей
+    template<typename It>
+    size_t insertBulk(It first, It last) {
+        size_t count = static_cast<size_t>(std::distance(first, last));
+        if (count == 0) return 0;
+        if (count >= NIL - nodes.size()) throw std::length_error("ChainingHashTable: слишком много элементов");
+
+        this->reserve(this->size + count);
+        if (!oldHeads.empty()) migrateBuckets(oldHeads.size());
+        nodes.reserve(nodes.size() + count);
+
+        auto staged = stageBulk<uint32_t>(first, last, this->capacity,
+                                          [this](const auto& key) { return hashOf(key); },
+                                          [this](uint32_t h) { return bucket(h); });
+        size_t before = this->size;
+        for (const auto& item : staged) {
+            auto [index, inserted] = emplaceHashed(item.hash, item.source->first, item.source->second);
+            if (!inserted) nodes[index].value = item.source->second;
+        }
+        return this->size - before;
+    }
+
+    // Вставка без копий: ключ и значение перемещаются или создаются на месте
+    // (узел пула строится прямо из аргументов). Указатели, полученные от
+    // lookup/tryEmplace/insertOrAssign, действительны до следующего изменения
+    // таблицы: вставки, удаления или rehash
+    template<typename KK, typename M>
+    std::pair<V*, bool> insertOrAssign(KK&& key, M&& value) {
+        auto [index, inserted] = emplaceImpl(std::forward<KK>(key), std::forward<M>(value));
+        if (!inserted) nodes[index].value = std::forward<M>(value);
+        return {&nodes[index].value, inserted};
+    }
+
+    // Создаёт значение из args, только если ключа ещё нет
+    template<typename... Args>
+    std::pair<V*, bool> tryEmplace(const K& key, Args&&... args) {
+        auto [index, inserted] = emplaceImpl(key, std::forward<Args>(args)...);
+        return {&nodes[index].value, inserted};
+    }
+
+    template<typename... Args>
+    std::pair<V*, bool> tryEmplace(K&& key, Args&&... args) {
+        auto [index, inserted] = emplaceImpl(std::move(key), std::forward<Args>(args)...);
+        return {&nodes[index].value, inserted};
+    }
+
+    // Байты, занятые пулом, массивами голов и фильтром (без динамических данных ключей/значений)
+    size_t memoryUsage() const {
+        return nodes.memoryUsage() +
+               (heads.capacity() + oldHeads.capacity() + preparedHeads.capacity()) * sizeof(uint32_t) +
+               this->bloom.memoryUsage();
+    }
+
+    // Итератор по парам ключ-значение. Пул узлов плотный, поэтому обход -
+    // последовательное чтение страниц без пропусков. Любая вставка или
+    // удаление делают итераторы недействительными. Разыменование даёт
+    // пару ссылок (прокси), а не ссылку на value_type, поэтому категория -
+    // input: проход многократный, но алгоритмы, которым нужна настоящая
+    // ссылка (forward), на этот итератор не рассчитаны
+    template<bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const ChainingHashTable, ChainingHashTable>;
+        using Value = std::conditional_t<Const, const V, V>;
+
+        Owner* owner;
+        size_t index;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<const K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, Value&>;
+        using pointer = ArrowProxy<reference>;
+
+        Iterator(Owner* table, size_t position) : owner(table), index(position) {}
+
+        reference operator*() const { return {owner->nodes[index].key, owner->nodes[index].value}; }
+        pointer operator->() const { return {**this}; }
+        const K& key() const { return owner->nodes[index].key; }
+        Value& value() const { return owner->nodes[index].value; }
+
+        Iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++index;
+            return copy;
+        }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, nodes.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, nodes.size()); }
+
+    // Обход без итератора: fn(key, value) для каждой пары
+    template<typename F>
+    void forEach(F fn) {
+        nodes.forEach([&](Node& node) { fn(static_cast<const K&>(node.key), node.value); });
+    }
+    template<typename F>
+    void forEach(F fn) const {
+        nodes.forEach([&](const Node& node) { fn(node.key, node.value); });
+    }
+
+    // Гистограмма длин цепочек по ячейкам, при постепенном rehash - вместе
+    // с ещё не перенесёнными. Счётчики ведут сами операции, так что stats()
+    // не обходит цепочки: стоимость - длина гистограммы
+    HashTableStats stats() const {
+        HashTableStats result = this->baseStats();
+        size_t length = chainCounts.size();
+        while (length > 0 && chainCounts[length - 1] == 0) --length;
+        result.lengthHistogram.assign(chainCounts.begin(), chainCounts.begin() + length);
+        result.maxLength = length ? length - 1 : 0;
+        return result;
+    }
+
+    void display() const {
+        std::cout << "\nХЕШ-ТАБЛИЦА С МЕТОДОМ ЦЕПОЧЕК\n";
+        for (size_t i = 0; i < heads.size(); ++i) {
+            if (heads[i] != NIL) {
+                std::cout << "Ячейка [" << i << "]: ";
+                for (uint32_t j = heads[i]; j != NIL; j = nodes[j].next)
+                    std::cout << "{" << nodes[j].key << " = " << nodes[j].value << "} ";
+                std::cout << std::endl;
+            }
+        }
+        for (size_t i = migrateIndex; i < oldHeads.size(); ++i) {
+            if (oldHeads[i] != NIL) {
+                std::cout << "Старая ячейка [" << i << "]: ";
+                for (uint32_t j = oldHeads[i]; j != NIL; j = nodes[j].next)
+                    std::cout << "{" << nodes[j].key << " = " << nodes[j].value << "} ";
+                std::cout << std::endl;
+            }
+        }
+    }
+};
+
+// ==========================================================
+// 3. ХЕШ-ТАБЛИЦА: ОТКРЫТАЯ АДРЕСАЦИЯ (Double Hashing)
+// ==========================================================
+
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class OpenAddressingHashTable final : public HashTableBase<OpenAddressingHashTable<K, V, Hash, KeyEqual>, K, V> {
+    using Base = HashTableBase<OpenAddressingHashTable, K, V>;
+    friend Base;
+    static constexpr double MAX_LOAD_LIMIT = 1.0;   // см. HashTableBase::MAX_LOAD_LIMIT
+
+private:
+    enum class EntryState : uint8_t { EMPTY, OCCUPIED, DELETED };
+
+    struct Entry {
+        K key;
+        V value;
+        size_t hash;   // полный хеш ключа: пробы сравнивают его до ключа, rehash не пересчитывает
+        uint32_t probes;   // номер пробы, на которой лежит запись (для stats); занимает выравнивание
+        EntryState state;
+        Entry() : hash(0), probes(0), state(EntryState::EMPTY) {}
+    };
+
+    std::vector<Entry> table;
+    Hash hasher;
+    KeyEqual equal;
+
+    // Битовая карта занятых ячеек (бит на ячейку): обход читает по 64
+    // ячейки за раз и не касается пустых и удалённых
+    std::vector<uint64_t> occupied;
+    std::vector<uint64_t> oldOccupied;   // то же для oldTable
+
+    static size_t bitmapWords(size_t slots) { return (slots + 63) / 64; }
+    static void setBit(std::vector<uint64_t>& bits, size_t index) { bits[index / 64] |= 1ull << (index % 64); }
+    static void clearBit(std::vector<uint64_t>& bits, size_t index) { bits[index / 64] &= ~(1ull << (index % 64)); }
+
+    // Номер первой занятой ячейки не раньше from или SIZE_MAX
+    static size_t nextOccupied(const std::vector<uint64_t>& bits, size_t from) {
+        size_t word = from / 64;
+        if (word >= bits.size()) return SIZE_MAX;
+        uint64_t mask = bits[word] & (~0ull << (from % 64));
+        while (!mask) {
+            if (++word == bits.size()) return SIZE_MAX;
+            mask = bits[word];
+        }
+        return word * 64 + __builtin_ctzll(mask);
+    }
+
+    template<typename Slots, typename F>
+    static void forEachIn(Slots& slots, const std::vector<uint64_t>& bits, F& fn) {
+        for (size_t word = 0; word < bits.size(); ++word) {
+            for (uint64_t mask = bits[word]; mask; mask &= mask - 1) {
+                auto& entry = slots[word * 64 + __builtin_ctzll(mask)];
+                fn(static_cast<const K&>(entry.key), entry.value);
+            }
+        }
+    }
+
+    // Запись образа для отображения в память (mappedHashTable.h)
+    friend struct SnapshotAccess;
+
+    // Постепенный rehash: пока oldTable не пуст, его ячейки с номерами от
+    // migrateIndex ещё не перенесены; перенесённые помечаются DELETED,
+    // чтобы не рвать цепочки проб оставшихся ключей
+    std::vector<Entry> oldTable;
+    size_t migrateIndex = 0;
+
+    // Счётчики для stats(), которые ведут вставка, удаление и перенос:
+    // записи обеих таблиц по номеру пробы и надгробия - DELETED в table и
+    // в ещё не перенесённой части oldTable
+    std::vector<size_t> probeCounts;
+    size_t tombstoneCount = 0;
+
+    void countPlaced(Entry& entry, size_t attempt) {
+        entry.probes = static_cast<uint32_t>(std::min<size_t>(attempt, UINT32_MAX));
+        if (entry.probes >= probeCounts.size()) probeCounts.resize(entry.probes + 1, 0);
+        probeCounts[entry.probes]++;
+    }
+
+    void countRemoved(const Entry& entry) { probeCounts[entry.probes]--; }
+
+    // Таблица для следующего роста: с 3/4 порога каждая вставка дописывает
+    // в неё часть пустых ячеек. Ёмкость простая - при переносе порциями
+    // пробы всегда обходят всю таблицу, и лишний рост не нужен
+    std::vector<Entry> preparedTable;
+    std::vector<uint64_t> preparedOccupied;
+    size_t preparedCapacity = 0;
+    size_t preparedFrom = 0;   // ёмкость, рост из которой готовится
+
+    // Перенесённая старая таблица: её записи разрушаются порциями, а не
+    // одним проходом в момент окончания переноса
+    std::vector<Entry> retiredTable;
+
+    template<typename Q>
+    size_t hashOf(const Q& key) const { return hasher(key); }
+
+    // Хеш считается один раз на операцию, обе функции двойного хеширования
+    // получаются из него
+    static size_t probe(size_t h, size_t attempt, size_t capacity) {
+        size_t h1 = h % capacity;
+        size_t h2 = 1 + (h % (capacity - 1));
+        return (h1 + attempt * h2) % capacity;
+    }
+
+    // Индекс занятой ячейки с ключом key в таблице slots или SIZE_MAX
+    template<typename Q>
+    size_t findSlot(const std::vector<Entry>& slots, const Q& key, size_t h) const {
+        size_t capacity = slots.size();
+        for (size_t attempt = 0; attempt < capacity; ++attempt) {
+            size_t index = probe(h, attempt, capacity);
+            const Entry& entry = slots[index];
+            if (entry.state == EntryState::EMPTY) return SIZE_MAX;
+            if (entry.state == EntryState::OCCUPIED && entry.hash == h && equal(entry.key, key)) return index;
+        }
+        return SIZE_MAX;
+    }
+
+    // Ячейка с ключом key в новой или ещё не перенесённой части старой таблицы
+    template<typename Q>
+    const Entry* locate(const Q& key, size_t h) const {
+        size_t index = findSlot(table, key, h);
+        if (index != SIZE_MAX) return &table[index];
+        if (!oldTable.empty()) {
+            index = findSlot(oldTable, key, h);
+            if (index != SIZE_MAX) return &oldTable[index];
+        }
+        return nullptr;
+    }
+
+    template<typename Q>
+    Entry* locate(const Q& key, size_t h) {
+        return const_cast<Entry*>(static_cast<const OpenAddressingHashTable*>(this)->locate(key, h));
+    }
+
+    template<typename F>
+    void forEachHash(F fn) const {
+        for (const auto* slots : {&table, &oldTable}) {
+            for (const auto& entry : *slots) {
+                if (entry.state == EntryState::OCCUPIED) fn(entry.hash);
+            }
+        }
+    }
+
+    template<typename Q>
+    const V* lookupImpl(const Q& key) const {
+        size_t h = hasher(key);
+        if (!this->bloomAllows(h)) return nullptr;
+        const Entry* entry = locate(key, h);
+        return entry ? &entry->value : nullptr;
+    }
+
+    template<typename Q>
+    bool findImpl(const Q& key, V& value) const {
+        const V* found = lookupImpl(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    // Групповая предвыборка: хеши всех ключей группы и загрузка их первых
+    // ячеек, затем полный поиск - к этому моменту ячейки уже в кеше
+    template<typename Ptr>
+    void findBatchImpl(const K* keys, size_t count, Ptr* values) const {
+        size_t hashes[BATCH_GROUP];
+        size_t capacity = table.size();
+        for (size_t start = 0; start < count; start += BATCH_GROUP) {
+            size_t n = std::min(BATCH_GROUP, count - start);
+            for (size_t i = 0; i < n; ++i) {
+                hashes[i] = hasher(keys[start + i]);
+                prefetchRead(&table[probe(hashes[i], 0, capacity)]);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                const Entry* entry = locate(keys[start + i], hashes[i]);
+                values[start + i] = entry ? const_cast<Ptr>(&entry->value) : nullptr;
+            }
+        }
+    }
+
+    void insertImpl(const K& key, const V& value) { insertOrAssign(key, value); }
+
+    template<typename Q>
+    bool removeImpl(const Q& key) {
+        migrateStep();
+        size_t h = hasher(key);
+        if (!this->bloomAllows(h)) return false;
+        Entry* entry = locate(key, h);
+        if (!entry) return false;
+        entry->state = EntryState::DELETED;
+        countRemoved(*entry);
+        tombstoneCount++;
+        std::less<const Entry*> before;
+        if (!before(entry, table.data()) && before(entry, table.data() + table.size())) {
+            clearBit(occupied, entry - table.data());
+        } else {
+            clearBit(oldOccupied, entry - oldTable.data());
+        }
+        this->size--;
+        this->bloomRemoved();
+        this->shrinkIfSparse();
+        return true;
+    }
+
+    static size_t nextPrime(size_t n) {
+        auto isPrime = [](size_t x) {
+            if (x < 4) return x > 1;
+            if (x % 2 == 0) return false;
+            for (size_t d = 3; d * d <= x; d += 2) {
+                if (x % d == 0) return false;
+            }
+            return true;
+        };
+        while (!isPrime(n)) n++;
+        return n;
+    }
+
+    // Ключ уникален, поэтому достаточно первой свободной ячейки по его хешу
+    void placeUnique(Entry&& entry) {
+        for (size_t attempt = 0; attempt < this->capacity; ++attempt) {
+            size_t index = probe(entry.hash, attempt, this->capacity);
+            if (table[index].state != EntryState::OCCUPIED) {
+                if (table[index].state == EntryState::DELETED) tombstoneCount--;
+                table[index] = std::move(entry);
+                setBit(occupied, index);
+                countPlaced(table[index], attempt);
+                return;
+            }
+        }
+        // Шаг двойного хеширования не взаимно прост с ёмкостью, и пробы обошли
+        // не все ячейки. Запись терять нельзя: новая таблица растёт ещё раз
+        std::vector<Entry> placed = std::move(table);
+        this->capacity *= 2;
+        table = std::vector<Entry>(this->capacity);
+        occupied.assign(bitmapWords(this->capacity), 0);
+        for (auto& other : placed) {
+            if (other.state == EntryState::DELETED) tombstoneCount--;
+            if (other.state != EntryState::OCCUPIED) continue;
+            countRemoved(other);
+            placeUnique(std::move(other));
+        }
+        placeUnique(std::move(entry));
+    }
+
+    // Переносит не больше count ячеек старой таблицы в новую
+    void migrateSlots(size_t count) {
+        for (; count > 0 && migrateIndex < oldTable.size(); --count, ++migrateIndex) {
+            Entry& entry = oldTable[migrateIndex];
+            if (entry.state == EntryState::OCCUPIED) {
+                countRemoved(entry);
+                placeUnique(std::move(entry));
+                entry.state = EntryState::DELETED;
+                clearBit(oldOccupied, migrateIndex);
+            } else if (entry.state == EntryState::DELETED) {
+                tombstoneCount--;   // надгробие старой таблицы уходит вместе с ней
+            }
+        }
+        if (migrateIndex == oldTable.size()) {
+            retiredTable = std::move(oldTable);
+            oldTable.clear();
+            std::vector<uint64_t>().swap(oldOccupied);
+            migrateIndex = 0;
+        }
+    }
+
+    void retireStep(size_t count) {
+        for (; count > 0 && !retiredTable.empty(); --count) retiredTable.pop_back();
+        if (retiredTable.empty()) std::vector<Entry>().swap(retiredTable);
+    }
+
+    void prepareStep() {
+        if (this->loadFactor() < this->loadFactorThreshold * 0.75) return;
+        if (preparedFrom != this->capacity) {
+            std::vector<Entry>().swap(preparedTable);
+            preparedCapacity = nextPrime(this->capacity * 2);
+            preparedTable.reserve(preparedCapacity);
+            preparedOccupied.clear();
+            preparedOccupied.reserve(bitmapWords(preparedCapacity));
+            preparedFrom = this->capacity;
+        }
+        for (size_t i = this->pacedStep(preparedCapacity - preparedTable.size()); i > 0; --i) {
+            preparedTable.emplace_back();
+        }
+        preparedOccupied.resize(bitmapWords(preparedTable.size()), 0);
+    }
 
-    virtual void rehash() = 0;
+    void releasePrepared() {
+        std::vector<Entry>().swap(preparedTable);
+        std::vector<uint64_t>().swap(preparedOccupied);
+        preparedCapacity = preparedFrom = 0;
+    }
+
+    // Работа постепенного rehash на одну операцию: перенос не меньше
+    // rehashStep ячеек, разрушение перенесённых записей и подготовка
+    // следующей таблицы, все в темпе, который успевает к следующему росту
+    void migrateStep() {
+        if (this->rehashStep == 0) return;
+        if (!oldTable.empty()) {
+            migrateSlots(std::max(this->rehashStep, this->pacedStep(oldTable.size() - migrateIndex)));
+        }
+        if (!retiredTable.empty()) retireStep(std::max(this->rehashStep, this->pacedStep(retiredTable.size())));
+        prepareStep();
+    }
+
+    void completeRehash() {
+        if (!oldTable.empty()) migrateSlots(oldTable.size());
+        retireStep(retiredTable.size());
+        releasePrepared();
+    }
+
+    // Рост при достижении порога: подготовленная таблица, если она готова
+    void grow() {
+        bool prepared = preparedFrom == this->capacity && preparedTable.size() == preparedCapacity;
+        resize(prepared ? preparedCapacity : this->capacity * 2);
+    }
+
+    // Перестраивает таблицу под newCapacity ячеек - и при росте, и при сжатии
+    void resize(size_t newCapacity) {
+        typename Base::RehashTimer timer(*this);
+        if (!oldTable.empty()) migrateSlots(oldTable.size());
+        bool parallel = this->rehashStep == 0 && this->rehashThreads > 1 && this->size >= PARALLEL_REHASH_MIN;
+        if (parallel) newCapacity = nextPrime(newCapacity);
+
+        std::vector<Entry> previous = std::move(table);
+        std::vector<uint64_t> previousOccupied = std::move(occupied);
+        
+        if (preparedFrom == this->capacity && preparedTable.size() == newCapacity) {
+            table = std::move(preparedTable);
+            occupied = std::move(preparedOccupied);
+        } else {
+            table = std::vector<Entry>(newCapacity);
+            occupied.assign(bitmapWords(newCapacity), 0);
+        }
+        releasePrepared();
+        this->capacity = newCapacity;
+
+        if (this->rehashStep > 0) {
+            // Старая таблица остаётся рядом и переносится порциями
+            oldTable = std::move(previous);
+            oldOccupied = std::move(previousOccupied);
+            migrateIndex = 0;
+            migrateStep();
+            return;
+        }
+
+        // В новой таблице нет надгробий - ключи раскладываются по сохранённым хешам
+        probeCounts.clear();
+        tombstoneCount = 0;
+        if (parallel) {
+            placeParallel(previous);
+            return;
+        }
+        for (auto& entry : previous) {
+            if (entry.state == EntryState::OCCUPIED) placeUnique(std::move(entry));
+        }
+    }
+
+    // Параллельный перенос: каждый поток берёт свой диапазон старой таблицы
+    // и занимает ячейки новой через compare-and-swap флага. Запись в ячейку
+    // делает только захвативший её поток. Ёмкость простая, поэтому пробы
+    // обходят всю таблицу и место находится всегда
+    void placeParallel(std::vector<Entry>& previous) {
+        size_t count = this->capacity;
+        std::unique_ptr<std::atomic<uint8_t>[]> claimed(new std::atomic<uint8_t>[count]);
+        parallelRanges(count, this->rehashThreads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) claimed[i].store(0, std::memory_order_relaxed);
+        });
+        // Гистограмма проб копится в каждом потоке и складывается под мьютексом
+        std::mutex countsLock;
+        parallelRanges(previous.size(), this->rehashThreads, [&](size_t begin, size_t end) {
+            std::vector<size_t> counts;
+            for (size_t i = begin; i < end; ++i) {
+                Entry& entry = previous[i];
+                if (entry.state != EntryState::OCCUPIED) continue;
+                for (size_t attempt = 0;; ++attempt) {
+                    size_t index = probe(entry.hash, attempt, count);
+                    uint8_t expected = 0;
+                    if (claimed[index].load(std::memory_order_relaxed) == 0 &&
+                        claimed[index].compare_exchange_strong(expected, 1, std::memory_order_relaxed)) {
+                        entry.probes = static_cast<uint32_t>(std::min<size_t>(attempt, UINT32_MAX));
+                        if (entry.probes >= counts.size()) counts.resize(entry.probes + 1, 0);
+                        counts[entry.probes]++;
+                        table[index] = std::move(entry);
+                        break;
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> guard(countsLock);
+            if (counts.size() > probeCounts.size()) probeCounts.resize(counts.size(), 0);
+            for (size_t i = 0; i < counts.size(); ++i) probeCounts[i] += counts[i];
+        });
+        // Битовая карта собирается по словам: каждое слово пишет один поток
+        parallelRanges(occupied.size(), this->rehashThreads, [&](size_t begin, size_t end) {
+            for (size_t word = begin; word < end; ++word) {
+                uint64_t bits = 0;
+                for (size_t j = 0; j < 64 && word * 64 + j < count; ++j) {
+                    if (claimed[word * 64 + j].load(std::memory_order_relaxed)) bits |= 1ull << j;
+                }
+                occupied[word] = bits;
+            }
+        });
+    }
 
 public:
-    HashTable(size_t initialCapacity = 16, double loadFactor = 0.9)
-        : capacity(initialCapacity), size(0), loadFactorThreshold(loadFactor) {}
+    using hash_type = Hash;
+    using key_equal_type = KeyEqual;
 
-    virtual ~HashTable() {}
+    OpenAddressingHashTable(size_t initialCapacity = 16, double loadFactor = 0.9,
+                            const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : Base(initialCapacity, loadFactor), table(initialCapacity),
+          hasher(hash), equal(keyEqual), occupied(bitmapWords(initialCapacity)) {}
 
-    virtual void insert(const K& key, const V& value) = 0;
-    virtual bool find(const K& key, V& value) const = 0;
-    virtual bool remove(const K& key) = 0;
-    virtual void display() const = 0;
+    bool isRehashing() const { return !oldTable.empty(); }
 
-    double loadFactor() const {
-        return static_cast<double>(size) / capacity;
+    // Задаёт число ячеек, но не меньше нужного для текущих элементов
+    // (и не меньше двух - иначе нет второго хеша). Надгробия при этом исчезают
+    void rehash(size_t newCapacity) {
+        resize(std::max({newCapacity, this->capacityFor(this->size), size_t(2)}));
     }
 
-    size_t getSize() const { return size; }
-    size_t getCapacity() const { return capacity; }
-    
-    virtual double measureFindTime(const vector<K>& keysToSearch, int m) const {
-        V dummy;
-        auto start = high_resolution_clock::now();
-        
-        for (int i = 0; i < m; i++) {
-            for (const auto& key : keysToSearch) {
-                find(key, dummy);
+    // Ячейка с ключом key и признак того, что она только что заполнена
+    // значением из args (существующая ячейка не трогается)
+    template<typename KK, typename... Args>
+    std::pair<Entry*, bool> emplaceImpl(KK&& key, Args&&... args) {
+        if (this->loadFactor() >= this->loadFactorThreshold) grow();
+        else migrateStep();
+        return emplaceHashed(hasher(key), std::forward<KK>(key), std::forward<Args>(args)...);
+    }
+
+    // То же без проверки заполненности, по уже посчитанному хешу
+    template<typename KK, typename... Args>
+    std::pair<Entry*, bool> emplaceHashed(size_t h, KK&& key, Args&&... args) {
+        if (!oldTable.empty()) {
+            // Ключ, ещё лежащий в старой таблице, остаётся на месте
+            size_t index = findSlot(oldTable, key, h);
+            if (index != SIZE_MAX) return {&oldTable[index], false};
+        }
+        while (true) {
+            // Удалённая ячейка может стоять раньше существующего ключа, поэтому
+            // запоминаем первую свободную и идём до пустой ячейки
+            size_t freeIndex = SIZE_MAX, freeAttempt = 0;
+            for (size_t attempt = 0; attempt < this->capacity; ++attempt) {
+                size_t index = probe(h, attempt, this->capacity);
+                Entry& entry = table[index];
+                if (entry.state == EntryState::OCCUPIED) {
+                    if (entry.hash == h && equal(entry.key, key)) return {&entry, false};
+                    continue;
+                }
+                if (freeIndex == SIZE_MAX) {
+                    freeIndex = index;
+                    freeAttempt = attempt;
+                }
+                if (entry.state == EntryState::EMPTY) break;
+            }
+            if (freeIndex != SIZE_MAX) {
+                Entry& entry = table[freeIndex];
+                if (entry.state == EntryState::DELETED) tombstoneCount--;
+                entry.key = std::forward<KK>(key);
+                entry.value = V(std::forward<Args>(args)...);
+                entry.hash = h;
+                entry.state = EntryState::OCCUPIED;
+                countPlaced(entry, freeAttempt);
+                setBit(occupied, freeIndex);
+                this->size++;
+                this->bloomAdded(h);
+                return {&entry, true};
+            }
+            grow();
+        }
+    }
+
+    // Пакетная загрузка пар (first - ключ, second - значение) из диапазона
+    // прямых итераторов. Ёмкость выделяется один раз, хеши считаются
+    // отдельным проходом, а записи ставятся в порядке домашних ячеек.
+    // Повторный ключ заменяет значение, как insert. Возвращает число новых ключей
+    template<typename It>
+    size_t insertBulk(It first, It last) {
+        size_t count = static_cast<size_t>(std::distance(first, last));
+        if (count == 0) return 0;
+
+        // При простой ёмкости любой шаг двойного хеширования взаимно прост
+        // с ней: пробы обходят всю таблицу, и плотная загрузка не вызывает
+        // лишнего роста
+        size_t needed = this->capacityFor(this->size + count);
+        if (needed > this->capacity) resize(nextPrime(needed));
+        if (!oldTable.empty()) migrateSlots(oldTable.size());
+
+        auto staged = stageBulk<size_t>(first, last, this->capacity,
+                                        [this](const auto& key) { return hasher(key); },
+                                        [this](size_t h) { return probe(h, 0, this->capacity); });
+        size_t before = this->size;
+        for (const auto& item : staged) {
+            auto [entry, inserted] = emplaceHashed(item.hash, item.source->first, item.source->second);
+            if (!inserted) entry->value = item.source->second;
+        }
+        return this->size - before;
+    }
+
+    // Вставка без копий: ключ и значение перемещаются в ячейку. Указатели,
+    // полученные от lookup/tryEmplace/insertOrAssign, действительны до
+    // следующего изменения таблицы: вставки, удаления или rehash
+    template<typename KK, typename M>
+    std::pair<V*, bool> insertOrAssign(KK&& key, M&& value) {
+        auto [entry, inserted] = emplaceImpl(std::forward<KK>(key), std::forward<M>(value));
+        if (!inserted) entry->value = std::forward<M>(value);
+        return {&entry->value, inserted};
+    }
+
+    // Создаёт значение из args, только если ключа ещё нет. Ячейки - уже
+    // созданные объекты массива, поэтому значение строится во временном
+    // объекте и перемещается в ячейку (одно перемещение, без копий)
+    template<typename... Args>
+    std::pair<V*, bool> tryEmplace(const K& key, Args&&... args) {
+        auto [entry, inserted] = emplaceImpl(key, std::forward<Args>(args)...);
+        return {&entry->value, inserted};
+    }
+
+    template<typename... Args>
+    std::pair<V*, bool> tryEmplace(K&& key, Args&&... args) {
+        auto [entry, inserted] = emplaceImpl(std::move(key), std::forward<Args>(args)...);
+        return {&entry->value, inserted};
+    }
+
+    // Итератор по занятым ячейкам: новая таблица, затем ещё не перенесённая
+    // часть старой. Следующая ячейка ищется по битовой карте. Любая вставка
+    // или удаление делают итераторы недействительными. Как и у цепочек,
+    // разыменование даёт прокси-пару ссылок, поэтому категория - input
+    template<bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const OpenAddressingHashTable, OpenAddressingHashTable>;
+        using Value = std::conditional_t<Const, const V, V>;
+
+        Owner* owner;
+        size_t part;    // 0 - table, 1 - oldTable, 2 - конец
+        size_t index;
+
+        auto& entry() const { return part == 0 ? owner->table[index] : owner->oldTable[index]; }
+
+        // Встаёт на первую занятую ячейку, начиная с текущей
+        void settle() {
+            for (; part < 2; ++part, index = 0) {
+                index = nextOccupied(part == 0 ? owner->occupied : owner->oldOccupied, index);
+                if (index != SIZE_MAX) return;
+            }
+            index = 0;
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<const K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, Value&>;
+        using pointer = ArrowProxy<reference>;
+
+        Iterator(Owner* table, size_t position) : owner(table), part(position), index(0) { settle(); }
+
+        reference operator*() const { return {entry().key, entry().value}; }
+        pointer operator->() const { return {**this}; }
+        const K& key() const { return entry().key; }
+        Value& value() const { return entry().value; }
+
+        Iterator& operator++() {
+            ++index;
+            settle();
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        bool operator==(const Iterator& other) const { return part == other.part && index == other.index; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, 2); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, 2); }
+
+    // Обход без итератора: fn(key, value) для каждой пары, слово карты за словом
+    template<typename F>
+    void forEach(F fn) {
+        forEachIn(table, occupied, fn);
+        forEachIn(oldTable, oldOccupied, fn);
+    }
+    template<typename F>
+    void forEach(F fn) const {
+        forEachIn(table, occupied, fn);
+        forEachIn(oldTable, oldOccupied, fn);
+    }
+
+    // Байты, занятые ячейками (со старой и подготовленной таблицами при
+    // постепенном rehash), битовыми картами и фильтром (без динамических
+    // данных ключей/значений)
+    size_t memoryUsage() const {
+        return (table.capacity() + oldTable.capacity() + preparedTable.capacity() + retiredTable.capacity()) * sizeof(Entry) +
+               (occupied.capacity() + oldOccupied.capacity() + preparedOccupied.capacity()) * sizeof(uint64_t) +
+               this->bloom.memoryUsage();
+    }
+
+    // Смещение каждого ключа - номер пробы, на которой он лежит, - и число
+    // надгробий. Счётчики ведут сами операции, так что stats() не обходит
+    // ячейки: стоимость - длина гистограммы
+    HashTableStats stats() const {
+        HashTableStats result = this->baseStats();
+        result.tombstones = tombstoneCount;
+        size_t length = probeCounts.size();
+        while (length > 0 && probeCounts[length - 1] == 0) --length;
+        result.lengthHistogram.assign(probeCounts.begin(), probeCounts.begin() + length);
+        result.maxLength = length ? length - 1 : 0;
+        return result;
+    }
+
+    void display() const {
+        std::cout << "\nХЕШ-ТАБЛИЦА С ОТКРЫТОЙ АДРЕСАЦИЕЙ\n";
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (table[i].state == EntryState::OCCUPIED) {
+                std::cout << "Ячейка [" << i << "]: {" << table[i].key << " = " << table[i].value << "}\n";
+            }
+        }
+        for (size_t i = migrateIndex; i < oldTable.size(); ++i) {
+            if (oldTable[i].state == EntryState::OCCUPIED) {
+                std::cout << "Старая ячейка [" << i << "]: {" << oldTable[i].key << " = " << oldTable[i].value << "}\n";
             }
         }
-        
-        auto end = high_resolution_clock::now();
-        auto duration = duration_cast<microseconds>(end - start);
-        return duration.count() / 1000000.0;
     }
 };
 
 // ==========================================================
-// 2. ХЕШ-ТАБЛИЦА: МЕТОД ЦЕПОЧЕК (Chaining)
+// 4. ХЕШ-ТАБЛИЦА: SWISS TABLE (управляющие байты + SIMD)
 // ==========================================================
+// Отдельный массив управляющих байтов: старший бит = 1 у пустых и
+// удалённых ячеек, у занятых в младших 7 битах лежит фрагмент хеша (h2).
+// Ячейки разбиты на группы по 16, группа сравнивается одной SSE2-командой,
+// ключ загружается только для ячеек с совпавшим фрагментом.
+
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class SwissHashTable final : public HashTableBase<SwissHashTable<K, V, Hash, KeyEqual>, K, V> {
+    using Base = HashTableBase<SwissHashTable, K, V>;
+    friend Base;
+    static constexpr double MAX_LOAD_LIMIT = 1.0;   // см. HashTableBase::MAX_LOAD_LIMIT
 
-template<typename K, typename V>
-class ChainingHashTable : public HashTable<K, V> {
 private:
-    std::vector<std::list<std::pair<K, V>>> table;
+    static constexpr size_t GROUP_SIZE = 16;
+    static constexpr int8_t CTRL_EMPTY = -128;   // 0b10000000
+    static constexpr int8_t CTRL_DELETED = -2;   // 0b11111110
+
+    std::vector<int8_t> ctrl;
+    std::vector<std::pair<K, V>> slots;
+    size_t deleted;   // число "надгробий", они тоже занимают место при вставке
+    Hash hasher;
+    KeyEqual equal;
+
+    // Ключи по номеру группы в последовательности проб - для stats();
+    // ведут вставка, удаление и перестройка
+    std::vector<size_t> probeCounts;
+
+    void countProbe(size_t attempt) {
+        if (attempt >= probeCounts.size()) probeCounts.resize(attempt + 1, 0);
+        probeCounts[attempt]++;
+    }
+
+    static size_t roundUpCapacity(size_t n) {
+        size_t result = GROUP_SIZE;
+        while (result < n) result <<= 1;
+        return result;
+    }
+
+    // Хеш должен хорошо перемешивать биты (как DefaultHash): номер группы
+    // берётся из старших битов, фрагмент h2 - из младших
+    template<typename Q>
+    size_t hashOf(const Q& key) const { return hasher(key); }
+    static size_t h1(size_t h) { return h >> 7; }
+    static int8_t h2(size_t h) { return static_cast<int8_t>(h & 0x7F); }
 
-    size_t hash(const K& key) const {
-        return std::hash<K>{}(key) % this->capacity;
+    size_t groupCount() const { return this->capacity / GROUP_SIZE; }
+
+    // Битовая маска ячеек группы, чей управляющий байт равен value
+    uint32_t matchByte(size_t group, int8_t value) const {
+        const int8_t* base = ctrl.data() + group * GROUP_SIZE;
+#if defined(__SSE2__)
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base));
+        __m128i cmp = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(value));
+        return static_cast<uint32_t>(_mm_movemask_epi8(cmp));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i)
+            if (base[i] == value) mask |= 1u << i;
+        return mask;
+#endif
+    }
+
+    // Маска свободных (пустых или удалённых) ячеек группы - у них старший бит = 1
+    uint32_t matchFree(size_t group) const {
+        const int8_t* base = ctrl.data() + group * GROUP_SIZE;
+#if defined(__SSE2__)
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base));
+        return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i)
+            if (base[i] < 0) mask |= 1u << i;
+        return mask;
+#endif
     }
 
-    void rehash() override {
-        size_t newCapacity = this->capacity * 2;
-        std::vector<std::list<std::pair<K, V>>> newTable(newCapacity);
+    static int lowestBit(uint32_t mask) { return __builtin_ctz(mask); }
+
+    // Треугольная последовательность групп обходит все группы при
+    // количестве групп, равном степени двойки
+    size_t probeGroup(size_t h, size_t attempt) const {
+        return (h1(h) + attempt * (attempt + 1) / 2) & (groupCount() - 1);
+    }
 
-        for (const auto& chain : table) {
-            for (const auto& pair : chain) {
-                size_t newIndex = std::hash<K>{}(pair.first) % newCapacity;
-                newTable[newIndex].push_back(pair);
+    // Индекс ячейки с ключом key или SIZE_MAX; в foundAttempt - номер
+    // группы в последовательности проб
+    template<typename Q>
+    size_t findIndex(const Q& key, size_t h, size_t* foundAttempt = nullptr) const {
+        for (size_t attempt = 0; attempt < groupCount(); ++attempt) {
+            size_t group = probeGroup(h, attempt);
+            for (uint32_t mask = matchByte(group, h2(h)); mask; mask &= mask - 1) {
+                size_t index = group * GROUP_SIZE + lowestBit(mask);
+                if (equal(slots[index].first, key)) {
+                    if (foundAttempt) *foundAttempt = attempt;
+                    return index;
+                }
             }
+            if (matchByte(group, CTRL_EMPTY)) return SIZE_MAX;
         }
-        table = std::move(newTable);
-        this->capacity = newCapacity;
+        return SIZE_MAX;
     }
 
-public:
-    ChainingHashTable(size_t initialCapacity = 16, double loadFactor = 0.9)
-        : HashTable<K, V>(initialCapacity, loadFactor), table(initialCapacity) {}
+    size_t findFreeSlot(size_t h, size_t& attempt) const {
+        for (attempt = 0; attempt < groupCount(); ++attempt) {
+            size_t group = probeGroup(h, attempt);
+            uint32_t mask = matchFree(group);
+            if (mask) return group * GROUP_SIZE + lowestBit(mask);
+        }
+        return SIZE_MAX;
+    }
 
-    void insert(const K& key, const V& value) override {
-        if (this->loadFactor() >= this->loadFactorThreshold) rehash();
+    void setCtrl(size_t index, int8_t value) { ctrl[index] = value; }
 
-        size_t index = hash(key);
-        for (auto& pair : table[index]) {
-            if (pair.first == key) {
-                pair.second = value;
-                return;
+    // Группе нужна хотя бы одна пустая ячейка, поэтому заполняем не больше 7/8
+    double maxFill() const { return std::min(this->loadFactorThreshold, 0.875); }
+
+    void grow() {
+        // Если место съели надгробия, достаточно перестроить таблицу того же размера
+        resize(this->size * 2 >= this->capacity ? this->capacity * 2 : this->capacity);
+    }
+
+    void resize(size_t newCapacity) {
+        typename Base::RehashTimer timer(*this);
+        std::vector<int8_t> oldCtrl = std::move(ctrl);
+        std::vector<std::pair<K, V>> oldSlots = std::move(slots);
+
+        ctrl.assign(newCapacity, CTRL_EMPTY);
+        slots = std::vector<std::pair<K, V>>(newCapacity);
+        this->capacity = newCapacity;
+        deleted = 0;
+        probeCounts.clear();
+
+        for (size_t i = 0; i < oldCtrl.size(); ++i) {
+            if (oldCtrl[i] >= 0) {
+                size_t h = hashOf(oldSlots[i].first);
+                size_t attempt;
+                size_t index = findFreeSlot(h, attempt);
+                countProbe(attempt);
+                setCtrl(index, h2(h));
+                slots[index] = std::move(oldSlots[i]);
             }
         }
-        table[index].emplace_back(key, value);
-        this->size++;
     }
 
-    bool find(const K& key, V& value) const override {
-        size_t index = hash(key);
-        for (const auto& pair : table[index]) {
-            if (pair.first == key) {
-                value = pair.second;
-                return true;
-            }
+    template<typename Q>
+    bool findImpl(const Q& key, V& value) const {
+        size_t index = findIndex(key, hashOf(key));
+        if (index == SIZE_MAX) return false;
+        value = slots[index].second;
+        return true;
+    }
+
+    void insertImpl(const K& key, const V& value) {
+        size_t h = hashOf(key);
+        size_t index = findIndex(key, h);
+        if (index != SIZE_MAX) {
+            slots[index].second = value;
+            return;
         }
-        return false;
+        if (needsGrowth()) grow();
+
+        size_t attempt;
+        index = findFreeSlot(h, attempt);
+        countProbe(attempt);
+        if (ctrl[index] == CTRL_DELETED) deleted--;
+        setCtrl(index, h2(h));
+        slots[index].first = key;
+        slots[index].second = value;
+        this->size++;
     }
 
-    bool remove(const K& key) override {
-        size_t index = hash(key);
-        auto& chain = table[index];
-        for (auto it = chain.begin(); it != chain.end(); ++it) {
-            if (it->first == key) {
-                chain.erase(it);
-                this->size--;
-                return true;
-            }
+    template<typename Q>
+    bool removeImpl(const Q& key) {
+        size_t attempt;
+        size_t index = findIndex(key, hashOf(key), &attempt);
+        if (index == SIZE_MAX) return false;
+        probeCounts[attempt]--;
+
+        // Если в группе есть пустая ячейка, ни одна цепочка проб через неё
+        // не проходила дальше - можно сразу пометить ячейку пустой
+        size_t group = index / GROUP_SIZE;
+        if (matchByte(group, CTRL_EMPTY)) {
+            setCtrl(index, CTRL_EMPTY);
+        } else {
+            setCtrl(index, CTRL_DELETED);
+            deleted++;
         }
-        return false;
+        slots[index] = std::pair<K, V>();
+        this->size--;
+        this->shrinkIfSparse();
+        return true;
     }
 
-    void display() const override {
-        std::cout << "\nХЕШ-ТАБЛИЦА С МЕТОДОМ ЦЕПОЧЕК\n";
-        for (size_t i = 0; i < table.size(); ++i) {
-            if (!table[i].empty()) {
-                std::cout << "Ячейка [" << i << "]: ";
-                for (const auto& pair : table[i]) 
-                    std::cout << "{" << pair.first << " = " << pair.second << "} ";
-                std::cout << std::endl;
+    bool needsGrowth() const {
+        return static_cast<double>(this->size + deleted + 1) / this->capacity > maxFill();
+    }
+
+public:
+    using hash_type = Hash;
+    using key_equal_type = KeyEqual;
+
+    SwissHashTable(size_t initialCapacity = 16, double loadFactor = 0.9,
+                   const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : Base(roundUpCapacity(initialCapacity), loadFactor),
+          ctrl(this->capacity, CTRL_EMPTY), slots(this->capacity), deleted(0),
+          hasher(hash), equal(keyEqual) {}
+
+    // Ёмкость - степень двойки не меньше 16, заполнение не выше 7/8
+    size_t capacityFor(size_t n) const {
+        return roundUpCapacity(static_cast<size_t>(static_cast<double>(n) / maxFill()) + 1);
+    }
+
+    // Задаёт число ячеек (с округлением до степени двойки), но не меньше
+    // нужного для текущих элементов. Надгробия при этом исчезают
+    void rehash(size_t newCapacity) {
+        resize(std::max(roundUpCapacity(newCapacity), capacityFor(this->size)));
+    }
+
+    // Байты, занятые управляющими байтами и ячейками
+    size_t memoryUsage() const {
+        return ctrl.capacity() * sizeof(int8_t) + slots.capacity() * sizeof(std::pair<K, V>);
+    }
+
+    // Смещение ключа считается в группах: 0 - ключ в родной группе.
+    // Берётся из счётчиков, без обхода ячеек и без хеширования ключей
+    HashTableStats stats() const {
+        HashTableStats result = this->baseStats();
+        result.tombstones = deleted;
+        size_t length = probeCounts.size();
+        while (length > 0 && probeCounts[length - 1] == 0) --length;
+        result.lengthHistogram.assign(probeCounts.begin(), probeCounts.begin() + length);
+        result.maxLength = length ? length - 1 : 0;
+        return result;
+    }
+
+    void display() const {
+        std::cout << "\nХЕШ-ТАБЛИЦА SWISS TABLE\n";
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (ctrl[i] >= 0) {
+                std::cout << "Ячейка [" << i << "]: {" << slots[i].first << " = " << slots[i].second << "}\n";
             }
         }
     }
 };
 
 // ==========================================================
-// 3. ХЕШ-ТАБЛИЦА: ОТКРЫТАЯ АДРЕСАЦИЯ (Double Hashing)
+// 5. ХЕШ-ТАБЛИЦА: ROBIN HOOD (линейное пробирование)
 // ==========================================================
+// Каждая ячейка хранит расстояние от "родной" позиции ключа. При вставке
+// "богатый" элемент (с меньшим расстоянием) уступает место "бедному",
+// поэтому разброс длин проб мал. Удаление сдвигает хвост кластера назад,
+// надгробий нет, и промах останавливается, как только расстояние пробы
+// превысило расстояние ключа в ячейке.
+
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class RobinHoodHashTable final : public HashTableBase<RobinHoodHashTable<K, V, Hash, KeyEqual>, K, V> {
+    using Base = HashTableBase<RobinHoodHashTable, K, V>;
+    friend Base;
+    static constexpr double MAX_LOAD_LIMIT = 1.0;   // см. HashTableBase::MAX_LOAD_LIMIT
 
-template<typename K, typename V>
-class OpenAddressingHashTable : public HashTable<K, V> {
 private:
-    enum class EntryState { EMPTY, OCCUPIED, DELETED };
+    static constexpr int32_t EMPTY_DIST = -1;
 
     struct Entry {
         K key;
         V value;
-        EntryState state;
-        Entry() : state(EntryState::EMPTY) {}
+        int32_t dist;   // расстояние от родной ячейки, EMPTY_DIST - ячейка пуста
+        Entry() : key(), value(), dist(EMPTY_DIST) {}
     };
 
     std::vector<Entry> table;
+    Hash hasher;
+    KeyEqual equal;
+
+    template<typename Q>
+    size_t hash(const Q& key) const {
+        return hasher(key) % this->capacity;
+    }
+
+    size_t next(size_t index) const {
+        return index + 1 == this->capacity ? 0 : index + 1;
+    }
+
+    template<typename Q>
+    size_t findIndex(const Q& key) const {
+        size_t index = hash(key);
+        for (int32_t dist = 0; ; ++dist) {
+            const Entry& entry = table[index];
+            if (entry.dist < dist) return SIZE_MAX;   // пустая или "богаче" нас
+            if (equal(entry.key, key)) return index;
+            index = next(index);
+        }
+    }
 
-    size_t hash(const K& key, size_t attempt) const {
-        size_t h1 = std::hash<K>{}(key) % this->capacity;
-        size_t h2 = 1 + (std::hash<K>{}(key) % (this->capacity - 1));
-        return (h1 + attempt * h2) % this->capacity;
+    template<typename Q>
+    bool findImpl(const Q& key, V& value) const {
+        size_t index = findIndex(key);
+        if (index == SIZE_MAX) return false;
+        value = table[index].value;
+        return true;
     }
 
-    void rehash() override {
-        size_t oldCapacity = this->capacity;
-        size_t newCapacity = oldCapacity * 2;
+    void insertImpl(const K& key, const V& value) {
+        size_t index = findIndex(key);
+        if (index != SIZE_MAX) {
+            table[index].value = value;
+            return;
+        }
+        if (static_cast<double>(this->size + 1) / this->capacity > this->loadFactorThreshold) resize(this->capacity * 2);
+        place(key, value);
+        this->size++;
+    }
+
+    template<typename Q>
+    bool removeImpl(const Q& key) {
+        size_t index = findIndex(key);
+        if (index == SIZE_MAX) return false;
+
+        // Обратный сдвиг: подтягиваем хвост кластера на одну ячейку назад
+        size_t nextIndex = next(index);
+        while (table[nextIndex].dist > 0) {
+            table[index].key = std::move(table[nextIndex].key);
+            table[index].value = std::move(table[nextIndex].value);
+            table[index].dist = table[nextIndex].dist - 1;
+            index = nextIndex;
+            nextIndex = next(nextIndex);
+        }
+        table[index] = Entry();
+        this->size--;
+        this->shrinkIfSparse();
+        return true;
+    }
+
+    // Вставка ключа, которого точно нет в таблице
+    void place(K key, V value) {
+        size_t index = hash(key);
+        int32_t dist = 0;
+        while (true) {
+            Entry& entry = table[index];
+            if (entry.dist == EMPTY_DIST) {
+                entry.key = std::move(key);
+                entry.value = std::move(value);
+                entry.dist = dist;
+                return;
+            }
+            if (entry.dist < dist) {
+                std::swap(entry.key, key);
+                std::swap(entry.value, value);
+                std::swap(entry.dist, dist);
+            }
+            index = next(index);
+            dist++;
+        }
+    }
+
+    void resize(size_t newCapacity) {
+        typename Base::RehashTimer timer(*this);
         std::vector<Entry> oldTable = std::move(table);
-        
-        table = std::vector<Entry>(newCapacity);
         this->capacity = newCapacity;
-        this->size = 0;
+        table = std::vector<Entry>(this->capacity);
 
-        for (const auto& entry : oldTable) {
-            if (entry.state == EntryState::OCCUPIED) {
-                insert(entry.key, entry.value);
-            }
+        for (auto& entry : oldTable) {
+            if (entry.dist != EMPTY_DIST) place(std::move(entry.key), std::move(entry.value));
         }
     }
 
 public:
-    OpenAddressingHashTable(size_t initialCapacity = 16, double loadFactor = 0.9)
-        : HashTable<K, V>(initialCapacity, loadFactor), table(initialCapacity) {}
+    using hash_type = Hash;
+    using key_equal_type = KeyEqual;
 
-    void insert(const K& key, const V& value) override {
-        if (this->loadFactor() >= this->loadFactorThreshold) rehash();
+    RobinHoodHashTable(size_t initialCapacity = 16, double loadFactor = 0.9,
+                       const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : Base(initialCapacity, loadFactor), table(initialCapacity),
+          hasher(hash), equal(keyEqual) {}
 
-        for (size_t attempt = 0; attempt < this->capacity; ++attempt) {
-            size_t index = hash(key, attempt);
-            if (table[index].state == EntryState::OCCUPIED && table[index].key == key) {
-                table[index].value = value;
-                return;
+    // Задаёт число ячеек, но не меньше нужного для текущих элементов
+    void rehash(size_t newCapacity) {
+        resize(std::max(newCapacity, this->capacityFor(this->size)));
+    }
+
+    // Наибольшее расстояние от родной ячейки - верхняя граница длины пробы
+    size_t maxProbeLength() const {
+        int32_t result = 0;
+        for (const auto& entry : table) result = std::max(result, entry.dist);
+        return static_cast<size_t>(result);
+    }
+
+    // Байты, занятые ячейками
+    size_t memoryUsage() const { return table.capacity() * sizeof(Entry); }
+
+    // Смещения уже хранятся в ячейках, надгробий нет
+    HashTableStats stats() const {
+        HashTableStats result = this->baseStats();
+        for (const auto& entry : table) {
+            if (entry.dist != EMPTY_DIST) result.addLength(static_cast<size_t>(entry.dist));
+        }
+        return result;
+    }
+
+    void display() const {
+        std::cout << "\nХЕШ-ТАБЛИЦА ROBIN HOOD\n";
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (table[i].dist != EMPTY_DIST) {
+                std::cout << "Ячейка [" << i << "]: {" << table[i].key << " = " << table[i].value
+                          << "} (смещение " << table[i].dist << ")\n";
             }
-            if (table[index].state != EntryState::OCCUPIED) {
-                table[index].key = key;
-                table[index].value = value;
-                table[index].state = EntryState::OCCUPIED;
-                this->size++;
-                return;
+        }
+    }
+};
+
+// ==========================================================
+// 6. ХЕШ-ТАБЛИЦА: КУКУШКА С КОРЗИНАМИ (Bucketized Cuckoo)
+// ==========================================================
+// У ключа ровно две корзины по 4 ячейки. Основная выбирается младшими
+// битами хеша, альтернативная - XOR основной с хешем 8-битного отпечатка
+// (partial-key cuckoo), поэтому при вытеснении ключ не хешируется заново.
+// Поиск смотрит только эти две корзины - для небольших K и V каждая
+// выровнена по кеш-линии, итого не больше двух линий - и маленький тайник,
+// если в нём что-то есть. При вставке в полные корзины ключи по очереди
+// вытесняются в свои альтернативные корзины, что держит заполнение выше 90%.
+
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class CuckooHashTable final : public HashTableBase<CuckooHashTable<K, V, Hash, KeyEqual>, K, V> {
+    using Base = HashTableBase<CuckooHashTable, K, V>;
+    friend Base;
+    static constexpr double MAX_LOAD_LIMIT = 1.0;   // см. HashTableBase::MAX_LOAD_LIMIT
+
+private:
+    static constexpr size_t SLOTS = 4;          // ячеек в корзине
+    static constexpr size_t STASH_LIMIT = 4;    // больше - повод расти
+    static constexpr size_t MAX_KICKS = 500;    // длина цепочки вытеснений
+
+    struct RawBucket {
+        uint8_t tags[SLOTS];   // отпечатки ключей, 0 - ячейка пуста
+        uint8_t alternates;    // бит i: ключ ячейки i лежит в альтернативной корзине
+        K keys[SLOTS];
+        V values[SLOTS];
+    };
+
+    // Корзина, помещающаяся в кеш-линию, выравнивается по ней
+    static constexpr size_t BUCKET_ALIGN = sizeof(RawBucket) <= 64 ? 64 : alignof(RawBucket);
+
+    struct alignas(BUCKET_ALIGN) Bucket : RawBucket {
+        Bucket() : RawBucket{} {}
+    };
+
+    std::vector<Bucket> buckets;
+    std::vector<std::pair<K, V>> stash;   // ключи, которым не нашлось места в корзинах
+    Hash hasher;
+    KeyEqual equal;
+    uint64_t kickState = 0x9E3779B97F4A7C15ull;   // xorshift для выбора вытесняемого
+    size_t alternateCount = 0;   // ключи в альтернативных корзинах, для stats()
+
+    void setAlternate(Bucket& bucket, size_t slot, bool onAlternate) {
+        uint8_t bit = static_cast<uint8_t>(1u << slot);
+        if (bucket.alternates & bit) alternateCount--;
+        bucket.alternates = static_cast<uint8_t>(onAlternate ? bucket.alternates | bit : bucket.alternates & ~bit);
+        if (onAlternate) alternateCount++;
+    }
+
+    // Число корзин - степень двойки, не меньше двух
+    static size_t roundUpBuckets(size_t capacity) {
+        size_t count = 2;
+        while (count * SLOTS < capacity) count <<= 1;
+        return count;
+    }
+
+    size_t mask() const { return buckets.size() - 1; }
+    static uint8_t tagOf(size_t h) {
+        uint8_t tag = static_cast<uint8_t>(h >> 56);
+        return tag ? tag : 1;
+    }
+    size_t primary(size_t h) const { return h & mask(); }
+    // Нечётное смещение: альтернативная корзина всегда другая, и из неё
+    // тем же XOR возвращаемся в основную
+    size_t alternate(size_t index, uint8_t tag) const {
+        return index ^ ((mixHash(tag) & mask()) | 1);
+    }
+
+    template<typename Q>
+    const V* lookupImpl(const Q& key) const {
+        size_t h = hasher(key);
+        uint8_t tag = tagOf(h);
+        size_t first = primary(h);
+        for (size_t index : {first, alternate(first, tag)}) {
+            const Bucket& bucket = buckets[index];
+            for (size_t i = 0; i < SLOTS; ++i) {
+                if (bucket.tags[i] == tag && equal(bucket.keys[i], key)) return &bucket.values[i];
             }
         }
-        rehash();
-        insert(key, value);
+        for (const auto& entry : stash) {
+            if (equal(entry.first, key)) return &entry.second;
+        }
+        return nullptr;
     }
 
-    bool find(const K& key, V& value) const override {
-        for (size_t attempt = 0; attempt < this->capacity; ++attempt) {
-            size_t index = hash(key, attempt);
-            if (table[index].state == EntryState::EMPTY) return false;
-            if (table[index].state == EntryState::OCCUPIED && table[index].key == key) {
-                value = table[index].value;
-                return true;
+    template<typename Q>
+    bool findImpl(const Q& key, V& value) const {
+        const V* found = lookupImpl(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    void insertImpl(const K& key, const V& value) {
+        if (V* existing = const_cast<V*>(lookupImpl(key))) {
+            *existing = value;
+            return;
+        }
+        if (static_cast<double>(this->size + 1) / this->capacity > this->loadFactorThreshold) {
+            resize(this->capacity * 2);
+        }
+        size_t h = hasher(key);
+        place(key, value, tagOf(h), primary(h));
+        this->size++;
+        // Переполненный тайник при заметной заполненности - корзинам тесно.
+        // При плохом хеше и почти пустой таблице рост не поможет, тайник растёт
+        if (stash.size() > STASH_LIMIT && this->loadFactor() >= 0.5) resize(this->capacity * 2);
+    }
+
+    template<typename Q>
+    bool removeImpl(const Q& key) {
+        size_t h = hasher(key);
+        uint8_t tag = tagOf(h);
+        size_t first = primary(h);
+        bool removed = false;
+        for (size_t index : {first, alternate(first, tag)}) {
+            Bucket& bucket = buckets[index];
+            for (size_t i = 0; i < SLOTS && !removed; ++i) {
+                if (bucket.tags[i] == tag && equal(bucket.keys[i], key)) {
+                    bucket.tags[i] = 0;
+                    setAlternate(bucket, i, false);
+                    bucket.keys[i] = K();
+                    bucket.values[i] = V();
+                    removed = true;
+                }
             }
+            if (removed) break;
         }
-        return false;
+        for (size_t i = 0; i < stash.size() && !removed; ++i) {
+            if (equal(stash[i].first, key)) {
+                stash[i] = std::move(stash.back());
+                stash.pop_back();
+                removed = true;
+            }
+        }
+        if (!removed) return false;
+        this->size--;
+        this->shrinkIfSparse();
+        return true;
     }
 
-    bool remove(const K& key) override {
-        for (size_t attempt = 0; attempt < this->capacity; ++attempt) {
-            size_t index = hash(key, attempt);
-            if (table[index].state == EntryState::EMPTY) return false;
-            if (table[index].state == EntryState::OCCUPIED && table[index].key == key) {
-                table[index].state = EntryState::DELETED;
-                this->size--;
+    bool putIfFree(size_t index, K& key, V& value, uint8_t tag, bool onAlternate) {
+        Bucket& bucket = buckets[index];
+        for (size_t i = 0; i < SLOTS; ++i) {
+            if (bucket.tags[i] == 0) {
+                bucket.tags[i] = tag;
+                setAlternate(bucket, i, onAlternate);
+                bucket.keys[i] = std::move(key);
+                bucket.values[i] = std::move(value);
                 return true;
             }
         }
         return false;
     }
 
-    void display() const override {
-        std::cout << "\nХЕШ-ТАБЛИЦА С ОТКРЫТОЙ АДРЕСАЦИЕЙ\n";
-        for (size_t i = 0; i < table.size(); ++i) {
-            if (table[i].state == EntryState::OCCUPIED) {
-                std::cout << "Ячейка [" << i << "]: {" << table[i].key << " = " << table[i].value << "}\n";
+    // Вставка ключа, которого точно нет в таблице. Если обе корзины полны,
+    // случайный сосед уступает место и переезжает в свою альтернативную
+    // корзину, и так не больше MAX_KICKS раз. Бездомный ключ уходит в тайник.
+    // onAlternate - index не основная корзина ключа; вытесненный сосед
+    // знает это о себе по биту alternates, так что хеш не пересчитывается
+    void place(K key, V value, uint8_t tag, size_t index, bool onAlternate = false) {
+        for (size_t kick = 0; kick < MAX_KICKS; ++kick) {
+            if (putIfFree(index, key, value, tag, onAlternate)) return;
+            size_t other = alternate(index, tag);
+            if (putIfFree(other, key, value, tag, !onAlternate)) return;
+
+            kickState ^= kickState << 13;
+            kickState ^= kickState >> 7;
+            kickState ^= kickState << 17;
+            size_t victimBucket = (kickState & 1) ? index : other;
+            size_t victimSlot = (kickState >> 1) % SLOTS;
+            Bucket& bucket = buckets[victimBucket];
+            bool victimOnAlternate = (bucket.alternates >> victimSlot) & 1;
+            std::swap(key, bucket.keys[victimSlot]);
+            std::swap(value, bucket.values[victimSlot]);
+            std::swap(tag, bucket.tags[victimSlot]);
+            setAlternate(bucket, victimSlot, victimBucket == index ? onAlternate : !onAlternate);
+            index = alternate(victimBucket, tag);
+            onAlternate = !victimOnAlternate;
+        }
+        stash.emplace_back(std::move(key), std::move(value));
+    }
+
+    void resize(size_t newCapacity) {
+        typename Base::RehashTimer timer(*this);
+        std::vector<Bucket> oldBuckets = std::move(buckets);
+        std::vector<std::pair<K, V>> oldStash = std::move(stash);
+        stash.clear();
+        buckets = std::vector<Bucket>(roundUpBuckets(newCapacity));
+        this->capacity = buckets.size() * SLOTS;
+        alternateCount = 0;
+
+        for (auto& bucket : oldBuckets) {
+            for (size_t i = 0; i < SLOTS; ++i) {
+                if (bucket.tags[i] == 0) continue;
+                size_t h = hasher(bucket.keys[i]);
+                place(std::move(bucket.keys[i]), std::move(bucket.values[i]), tagOf(h), primary(h));
+            }
+        }
+        for (auto& entry : oldStash) {
+            size_t h = hasher(entry.first);
+            place(std::move(entry.first), std::move(entry.second), tagOf(h), primary(h));
+        }
+    }
+
+public:
+    using hash_type = Hash;
+    using key_equal_type = KeyEqual;
+
+    CuckooHashTable(size_t initialCapacity = 16, double loadFactor = 0.95,
+                    const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : Base(roundUpBuckets(initialCapacity) * SLOTS, loadFactor),
+          buckets(this->capacity / SLOTS), hasher(hash), equal(keyEqual) {}
+
+    // Ёмкость - степень двойки корзин по 4 ячейки
+    size_t capacityFor(size_t n) const {
+        return roundUpBuckets(static_cast<size_t>(static_cast<double>(n) / this->loadFactorThreshold) + 1) * SLOTS;
+    }
+
+    // Задаёт число ячеек (с округлением до целого числа корзин), но не
+    // меньше нужного для текущих элементов
+    void rehash(size_t newCapacity) {
+        resize(std::max(roundUpBuckets(newCapacity) * SLOTS, capacityFor(this->size)));
+    }
+
+    size_t stashSize() const { return stash.size(); }
+
+    // Байты, занятые корзинами и тайником
+    size_t memoryUsage() const {
+        return buckets.capacity() * sizeof(Bucket) + stash.capacity() * sizeof(std::pair<K, V>);
+    }
+
+    // Смещение: 0 - ключ в основной корзине, 1 - в альтернативной, 2 - в
+    // тайнике. Вставка, вытеснение и удаление ведут счётчик альтернативных,
+    // так что stats() не обходит корзины и не хеширует ключи
+    HashTableStats stats() const {
+        HashTableStats result = this->baseStats();
+        result.lengthHistogram = {this->size - alternateCount - stash.size(), alternateCount, stash.size()};
+        size_t length = result.lengthHistogram.size();
+        while (length > 0 && result.lengthHistogram[length - 1] == 0) --length;
+        result.lengthHistogram.resize(length);
+        result.maxLength = length ? length - 1 : 0;
+        return result;
+    }
+
+    void display() const {
+        std::cout << "\nХЕШ-ТАБЛИЦА КУКУШКИ\n";
+        for (size_t index = 0; index < buckets.size(); ++index) {
+            for (size_t i = 0; i < SLOTS; ++i) {
+                if (buckets[index].tags[i] == 0) continue;
+                std::cout << "Корзина [" << index << "]: {" << buckets[index].keys[i] << " = "
+                          << buckets[index].values[i] << "}\n";
             }
         }
+        for (const auto& entry : stash) {
+            std::cout << "Тайник: {" << entry.first << " = " << entry.second << "}\n";
+        }
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,105 @@
+#ifndef INTERNEDSTRINGS_H
+#define INTERNEDSTRINGS_H
+
+#include "hashTables.h"
+#include <cstring>
+#include <memory>
+
+// ==========================================================
+// 1. ИНТЕРНИРОВАННЫЕ СТРОКИ
+// ==========================================================
+// Каждая различная строка хранится один раз в арене - блоках, которые
+// только дописываются и никогда не перемещаются. В таблице вместо строки
+// лежит 32-битный номер (InternedKey): ключи сравниваются как числа,
+// хеш - перемешанный номер, и узел ChainingHashTable<InternedKey, int>
+// занимает 16 байт вместо 48 у <std::string, int>. Повторяющиеся ключи
+// во многих таблицах делят одну копию текста.
+// StringInterner не потокобезопасен.
+
+struct InternedKey {
+    uint32_t id;
+
+    bool operator==(const InternedKey& other) const { return id == other.id; }
+    bool operator!=(const InternedKey& other) const { return id != other.id; }
+};
+
+// Текст ключа знает только StringInterner, поэтому display печатает номер
+inline std::ostream& operator<<(std::ostream& out, const InternedKey& key) {
+    return out << '#' << key.id;
+}
+
+namespace std {
+template<>
+struct hash<InternedKey> {
+    size_t operator()(const InternedKey& key) const noexcept { return key.id; }
+};
+}
+
+class StringInterner {
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* current = nullptr;     // свободное место в последнем обычном блоке
+    size_t remaining = 0;
+    size_t arenaBytes = 0;
+
+    std::vector<std::string_view> strings;                // номер -> текст в арене
+    ChainingHashTable<std::string_view, uint32_t> index;  // текст -> номер
+
+    // Копирует текст в арену. Длинная строка получает отдельный блок,
+    // чтобы не оставлять пустым хвост текущего
+    const char* store(std::string_view text) {
+        if (text.empty()) return "";
+        if (text.size() > BLOCK_SIZE / 4) {
+            blocks.emplace_back(new char[text.size()]);
+            arenaBytes += text.size();
+            std::memcpy(blocks.back().get(), text.data(), text.size());
+            return blocks.back().get();
+        }
+        if (text.size() > remaining) {
+            blocks.emplace_back(new char[BLOCK_SIZE]);
+            arenaBytes += BLOCK_SIZE;
+            current = blocks.back().get();
+            remaining = BLOCK_SIZE;
+        }
+        char* result = current;
+        std::memcpy(result, text.data(), text.size());
+        current += text.size();
+        remaining -= text.size();
+        return result;
+    }
+
+public:
+    // Номер строки; новая строка копируется в арену при первом обращении
+    InternedKey intern(std::string_view text) {
+        if (const uint32_t* id = index.lookup(text)) return {*id};
+        if (strings.size() == UINT32_MAX) throw std::length_error("StringInterner: слишком много строк");
+
+        std::string_view stored(store(text), text.size());
+        uint32_t id = static_cast<uint32_t>(strings.size());
+        strings.push_back(stored);
+        index.insert(stored, id);
+        return {id};
+    }
+
+    // Номер уже интернированной строки; новую строку не добавляет
+    bool lookup(std::string_view text, InternedKey& key) const {
+        const uint32_t* id = index.lookup(text);
+        if (!id) return false;
+        key.id = *id;
+        return true;
+    }
+
+    // Текст по номеру; действителен, пока жив StringInterner
+    std::string_view view(InternedKey key) const { return strings.at(key.id); }
+
+    size_t size() const { return strings.size(); }
+
+    // Арена, таблица номеров и индекс текст -> номер
+    size_t memoryUsage() const {
+        return arenaBytes + strings.capacity() * sizeof(std::string_view) + index.memoryUsage();
+    }
+};
+
+#endif
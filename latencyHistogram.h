@@ -0,0 +1,294 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ==========================================================
+// 1. ЛОГАРИФМИЧЕСКИ-ЛИНЕЙНАЯ ГИСТОГРАММА ЗАДЕРЖЕК
+// ==========================================================
+// Значения до 32 хранятся точно, дальше каждая степень двойки делится
+// на 16 равных корзин (как в HdrHistogram): относительная ошибка не
+// больше 1/16, а весь диапазон uint64 умещается в 976 счётчиков.
+// Гистограммы складываются (merge), так что потоки и таблицы можно
+// считать отдельно и объединять при выгрузке.
+
+// Счётчик тактов процессора; на других архитектурах - наносекунды steady_clock
+inline uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Тактов в наносекунде; калибруется один раз по steady_clock (около 10 мс)
+inline double cyclesPerNanosecond() {
+    static const double rate = [] {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t first = readCycles();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10)) {}
+        uint64_t cycles = readCycles() - first;
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return cycles > 0 ? cycles / nanoseconds : 1.0;
+    }();
+    return rate;
+}
+
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr size_t EXACT = size_t(1) << SUB_BITS;   // 32 точных значения
+    static constexpr size_t HALF = EXACT / 2;                // корзин на степень двойки
+    static constexpr size_t BUCKETS = EXACT + (64 - SUB_BITS) * HALF;
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < EXACT) return static_cast<size_t>(value);
+        unsigned shift = highestBit(value) - SUB_BITS + 1;
+        return EXACT + (shift - 1) * HALF + static_cast<size_t>((value >> shift) - HALF);
+    }
+
+    // Границы корзины включительно
+    static uint64_t lowerBound(size_t bucket) {
+        if (bucket < EXACT) return bucket;
+        size_t k = bucket - EXACT;
+        unsigned shift = static_cast<unsigned>(k / HALF) + 1;
+        return static_cast<uint64_t>(HALF + k % HALF) << shift;
+    }
+
+    static uint64_t upperBound(size_t bucket) {
+        if (bucket < EXACT) return bucket;
+        size_t k = bucket - EXACT;
+        unsigned shift = static_cast<unsigned>(k / HALF) + 1;
+        return lowerBound(bucket) + ((uint64_t(1) << shift) - 1);
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> counts{};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+
+    static unsigned highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit = 0;
+        while (value >>= 1) bit++;
+        return bit;
+#endif
+    }
+
+public:
+    void record(uint64_t value, uint64_t count = 1) {
+        counts[bucketOf(value)] += count;
+        total += count;
+        sum += value * count;
+    }
+
+    // Добавляет счётчики корзины напрямую - для сборки из потоковых копий
+    void addBucket(size_t bucket, uint64_t count, uint64_t valueSum) {
+        counts[bucket] += count;
+        total += count;
+        sum += valueSum;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t b = 0; b < BUCKETS; ++b) counts[b] += other.counts[b];
+        total += other.total;
+        sum += other.sum;
+    }
+
+    void reset() { *this = LatencyHistogram(); }
+
+    uint64_t count() const { return total; }
+    uint64_t countIn(size_t bucket) const { return counts[bucket]; }
+    double mean() const { return total == 0 ? 0.0 : static_cast<double>(sum) / total; }
+
+    // Значение, не меньше которого p процентов записей (верхняя граница
+    // корзины, где лежит нужный ранг); p = 100 - оценка максимума
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, total));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            seen += counts[b];
+            if (seen >= rank) return upperBound(b);
+        }
+        return upperBound(BUCKETS - 1);
+    }
+
+    // Нижняя граница первой непустой корзины
+    uint64_t minValue() const {
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            if (counts[b] != 0) return lowerBound(b);
+        }
+        return 0;
+    }
+    uint64_t maxValue() const { return percentile(100); }
+
+    // Выгрузка в CSV: непустые корзины "нижняя,верхняя,число". Без scale
+    // границы пишутся целыми тактами, иначе делятся на scale (например,
+    // на cyclesPerNanosecond() для наносекунд)
+    void exportCsv(std::ostream& out, double scale = 1.0) const {
+        out << "low,high,count\n";
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            if (counts[b] == 0) continue;
+            if (scale == 1.0) out << lowerBound(b) << ',' << upperBound(b);
+            else out << lowerBound(b) / scale << ',' << upperBound(b) / scale;
+            out << ',' << counts[b] << '\n';
+        }
+    }
+};
+
+// ==========================================================
+// 2. ЗАПИСЬ ЗАДЕРЖЕК ОПЕРАЦИЙ ИЗ МНОГИХ ПОТОКОВ
+// ==========================================================
+// У каждого потока своя копия счётчиков (shard), поэтому запись обычно
+// не делит кеш-линии с другими потоками. Потоки нумеруются один раз на
+// процесс и делят MAX_SHARDS копий по кругу, так что копия может
+// оказаться общей: счётчики увеличиваются атомарным fetch_add (relaxed),
+// и одновременные записи не теряются. Без соперника это одна инструкция
+// над своей кеш-линией. snapshot складывает копии в обычную LatencyHistogram.
+//
+// Рекордер встроен в каждую таблицу, поэтому без замеров он - один
+// указатель. Массив копий выделяется при первой записи, а каждая копия
+// (около 23 КБ) - при первой записи своего потока: таблица, которую
+// трогают k потоков, держит не больше min(k, MAX_SHARDS) копий.
+
+enum class HashOp { INSERT, FIND, REMOVE };
+constexpr size_t HASH_OP_COUNT = 3;
+
+class LatencyRecorder {
+public:
+    static constexpr size_t MAX_SHARDS = 16;
+
+private:
+    struct Shard {
+        std::array<std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS>, HASH_OP_COUNT> counts;
+        std::array<std::atomic<uint64_t>, HASH_OP_COUNT> sums;
+
+        Shard() {
+            for (auto& op : counts) {
+                for (auto& count : op) count.store(0, std::memory_order_relaxed);
+            }
+            for (auto& value : sums) value.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct ShardSet {
+        std::array<std::atomic<Shard*>, MAX_SHARDS> shards{};
+
+        ~ShardSet() {
+            for (auto& shard : shards) delete shard.load(std::memory_order_relaxed);
+        }
+    };
+
+    std::atomic<ShardSet*> shardSet{nullptr};
+
+    // Номер копии для текущего потока: потоки нумеруются при первом
+    // обращении, и после MAX_SHARDS потоков номера повторяются
+    static size_t threadSlot() {
+        static std::atomic<size_t> nextSlot{0};
+        thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % MAX_SHARDS;
+        return slot;
+    }
+
+    // Выделяет объект в entry, если его там ещё нет; проигравший гонку
+    // поток удаляет свой и берёт созданный другим
+    template<typename T>
+    static T& getOrCreate(std::atomic<T*>& entry) {
+        T* current = entry.load(std::memory_order_acquire);
+        if (current) return *current;
+        std::unique_ptr<T> created(new T());
+        if (entry.compare_exchange_strong(current, created.get(), std::memory_order_acq_rel)) return *created.release();
+        return *current;
+    }
+
+    Shard& shardForThread() { return getOrCreate(getOrCreate(shardSet).shards[threadSlot()]); }
+
+
+public:
+    LatencyRecorder() = default;
+
+    // Задержки принадлежат объекту, а не содержимому: копия таблицы
+    // начинает с пустых счётчиков, присваивание сохраняет свои
+    LatencyRecorder(const LatencyRecorder&) {}
+    LatencyRecorder& operator=(const LatencyRecorder&) { return *this; }
+
+    ~LatencyRecorder() { delete shardSet.load(std::memory_order_relaxed); }
+
+    void record(HashOp op, uint64_t cycles) {
+        Shard& shard = shardForThread();
+        size_t index = static_cast<size_t>(op);
+        shard.counts[index][LatencyHistogram::bucketOf(cycles)].fetch_add(1, std::memory_order_relaxed);
+        shard.sums[index].fetch_add(cycles, std::memory_order_relaxed);
+    }
+
+    // Сумма всех потоков на текущий момент; пишущие потоки не блокируются
+    LatencyHistogram snapshot(HashOp op) const {
+        LatencyHistogram result;
+        const ShardSet* set = shardSet.load(std::memory_order_acquire);
+        if (!set) return result;
+        size_t index = static_cast<size_t>(op);
+        for (const auto& entry : set->shards) {
+            const Shard* shard = entry.load(std::memory_order_acquire);
+            if (!shard) continue;
+            uint64_t valueSum = shard->sums[index].load(std::memory_order_relaxed);
+            for (size_t b = 0; b < LatencyHistogram::BUCKETS; ++b) {
+                uint64_t count = shard->counts[index][b].load(std::memory_order_relaxed);
+                if (count == 0) continue;
+                result.addBucket(b, count, valueSum);
+                valueSum = 0;   // сумма значений переносится один раз на копию
+            }
+        }
+        return result;
+    }
+
+    // Число выделенных копий счётчиков
+    size_t shardCount() const {
+        const ShardSet* set = shardSet.load(std::memory_order_acquire);
+        if (!set) return 0;
+        size_t count = 0;
+        for (const auto& entry : set->shards) count += entry.load(std::memory_order_acquire) != nullptr;
+        return count;
+    }
+
+    // Обнулять счётчики безопасно, только пока в таблицу никто не пишет
+    void reset() {
+        ShardSet* set = shardSet.load(std::memory_order_acquire);
+        if (!set) return;
+        for (auto& entry : set->shards) {
+            Shard* shard = entry.load(std::memory_order_acquire);
+            if (!shard) continue;
+            for (auto& op : shard->counts) {
+                for (auto& count : op) count.store(0, std::memory_order_relaxed);
+            }
+            for (auto& value : shard->sums) value.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Засекает одну операцию: объявляется в начале метода
+class LatencyTimer {
+    LatencyRecorder& recorder;
+    HashOp op;
+    uint64_t start;
+
+public:
+    LatencyTimer(LatencyRecorder& owner, HashOp operation) : recorder(owner), op(operation), start(readCycles()) {}
+    ~LatencyTimer() { recorder.record(op, readCycles() - start); }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+};
+
+#endif
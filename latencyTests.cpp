@@ -0,0 +1,93 @@
+// Замеры задержек включены для всей этой единицы трансляции. Макрос
+// должен совпадать во всех файлах программы, поэтому файл собирается
+// отдельной целью вместе с main_test.cpp, а не вместе с tests.cpp
+#define HASHTABLE_LATENCY
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hashTables.h"
+#include "concurrentHashTables.h"
+
+TEST(LatencyHistogramTest, InstrumentedTable) {
+    std::unique_ptr<HashTable<int, int>> table(new PolymorphicHashTable<OpenAddressingHashTable<int, int>>());
+    const int n = 200000;
+    for (int i = 0; i < n; ++i) table->insert(i, i);
+    int value = 0;
+    for (int i = 0; i < n; ++i) table->find(i * 2, value);
+    for (int i = 0; i < n / 2; ++i) table->remove(i);
+
+    LatencyHistogram inserts = table->latencyHistogram(HashOp::INSERT);
+    LatencyHistogram finds = table->latencyHistogram(HashOp::FIND);
+    EXPECT_EQ(inserts.count(), static_cast<uint64_t>(n));
+    EXPECT_EQ(finds.count(), static_cast<uint64_t>(n));
+    EXPECT_EQ(table->latencyHistogram(HashOp::REMOVE).count(), static_cast<uint64_t>(n / 2));
+    // Вставка, вызвавшая rehash всей таблицы, на порядки дольше медианы
+    EXPECT_GT(inserts.maxValue(), 100 * inserts.percentile(50));
+
+    table->resetLatency();
+    EXPECT_EQ(table->latencyHistogram(HashOp::FIND).count(), 0u);
+}
+
+// Замер стоит в операциях HashTableBase: его видят и прямые вызовы
+// таблиц, без адаптера, по каждой операции один раз
+TEST(LatencyHistogramTest, DirectTableOperations) {
+    ChainingHashTable<std::string, int> chain;
+    RobinHoodHashTable<int, int> robin;
+    CuckooHashTable<int, int> cuckoo;
+    for (int i = 0; i < 1000; ++i) {
+        chain.insert(std::to_string(i), i);
+        robin.insert(i, i);
+        cuckoo.insert(i, i);
+    }
+    int value = 0;
+    for (int i = 0; i < 500; ++i) {
+        chain.lookup(std::to_string(i));
+        robin.find(i, value);
+        cuckoo.remove(i);
+    }
+    chain.find(std::string_view("7"), value);
+
+    EXPECT_EQ(chain.latencyHistogram(HashOp::INSERT).count(), 1000u);
+    EXPECT_EQ(chain.latencyHistogram(HashOp::FIND).count(), 501u);
+    EXPECT_EQ(robin.latencyHistogram(HashOp::FIND).count(), 500u);
+    EXPECT_EQ(robin.latencyHistogram(HashOp::REMOVE).count(), 0u);
+    // Вставка в Cuckoo ищет ключ сама, без второго замера find
+    EXPECT_EQ(cuckoo.latencyHistogram(HashOp::INSERT).count(), 1000u);
+    EXPECT_EQ(cuckoo.latencyHistogram(HashOp::FIND).count(), 0u);
+    EXPECT_EQ(cuckoo.latencyHistogram(HashOp::REMOVE).count(), 500u);
+
+    // Копия таблицы начинает с пустых счётчиков
+    ChainingHashTable<std::string, int> copy(chain);
+    EXPECT_EQ(copy.getSize(), chain.getSize());
+    EXPECT_EQ(copy.latencyHistogram(HashOp::INSERT).count(), 0u);
+    copy.insert("new", 1);
+    EXPECT_EQ(copy.latencyHistogram(HashOp::INSERT).count(), 1u);
+    EXPECT_EQ(chain.latencyHistogram(HashOp::INSERT).count(), 1000u);
+}
+
+// find сегмента идут из многих потоков под разделяемой блокировкой и
+// одновременно пишут в рекордер его таблицы: ни одна запись не теряется
+// (гонки ловит сборка с TSAN)
+TEST(LatencyHistogramTest, ConcurrentReaders) {
+    ConcurrentChainingHashTable<int, int> table(1024, 0.9, 4);
+    const int n = 4000;
+    for (int i = 0; i < n; ++i) table.insert(i, i);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&table] {
+            int value = 0;
+            for (int i = 0; i < n; ++i) table.find(i, value);
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    int found = 0;
+    EXPECT_TRUE(table.find(n - 1, found));
+    EXPECT_EQ(found, n - 1);
+    EXPECT_EQ(table.latencyHistogram(HashOp::FIND).count(), static_cast<uint64_t>(4 * n + 1));
+    EXPECT_EQ(table.latencyHistogram(HashOp::INSERT).count(), static_cast<uint64_t>(n));
+
+    table.resetLatency();
+    EXPECT_EQ(table.latencyHistogram(HashOp::FIND).count(), 0u);
+}
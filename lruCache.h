@@ -0,0 +1,295 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include "hashTables.h"
+
+// ==========================================================
+// 1. ВЕС ЗАПИСИ
+// ==========================================================
+// Ёмкость кеша задаётся в единицах веса. По умолчанию каждая запись
+// весит 1 (ёмкость - число записей); CacheBytes считает занятые байты,
+// включая буфер std::string.
+
+template<typename T>
+size_t cacheBytes(const T&) { return sizeof(T); }
+
+inline size_t cacheBytes(const std::string& text) { return sizeof(std::string) + text.capacity(); }
+
+struct CacheEntries {
+    template<typename K, typename V>
+    size_t operator()(const K&, const V&) const { return 1; }
+};
+
+struct CacheBytes {
+    template<typename K, typename V>
+    size_t operator()(const K& key, const V& value) const { return cacheBytes(key) + cacheBytes(value); }
+};
+
+// ==========================================================
+// 2. КЕШ С ВЫТЕСНЕНИЕМ (LRU / CLOCK)
+// ==========================================================
+// Записи лежат в пуле и связаны двусвязным списком давности (prev/next,
+// как узлы StringDL, только 32-битными индексами): голова - самая
+// свежая, хвост - кандидат на вытеснение. Место удалённой записи
+// уходит в список свободных, поэтому номер записи не меняется, пока
+// она в кеше. ChainingHashTable отображает номер записи в неё же: хеш и
+// сравнение берут ключ из самой записи, так что ключ хранится один раз
+// и весом учитывается честно, а get и put - O(1).
+//
+// LRU на каждом попадании переставляет запись в голову - это четыре
+// записи в чужие узлы. CLOCK на попадании только ставит бит обращения;
+// при вытеснении запись с битом получает второй шанс и уходит в голову
+// со сброшенным битом. Порядок вытеснения близок к LRU, а путь
+// попадания не пишет в список.
+// LruCache не потокобезопасен и не копируется: индекс ссылается на пул
+// записей своего кеша.
+
+enum class EvictionPolicy { LRU, CLOCK };
+
+template<typename K, typename V, typename Weigher = CacheEntries,
+         typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class LruCache {
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Entry {
+        K key;
+        V value;
+        size_t weight;
+        uint32_t prev;
+        uint32_t next;
+        bool referenced;   // бит обращения для CLOCK
+
+        template<typename KK, typename VV>
+        Entry(KK&& k, VV&& v)
+            : key(std::forward<KK>(k)), value(std::forward<VV>(v)), weight(0), prev(NIL), next(NIL), referenced(false) {}
+    };
+
+    // Ключ индекса - номер записи в пуле
+    struct Handle {
+        uint32_t entry;
+    };
+
+    struct HandleHash {
+        using is_transparent = void;
+        const std::vector<Entry>* entries;
+        Hash hasher;
+
+        size_t operator()(Handle handle) const { return hasher((*entries)[handle.entry].key); }
+        template<typename Q>
+        size_t operator()(const Q& key) const { return hasher(key); }
+    };
+
+    struct HandleEqual {
+        using is_transparent = void;
+        const std::vector<Entry>* entries;
+        KeyEqual equal;
+
+        // Ключи записей в индексе различны, поэтому номера равны только у одной записи
+        bool operator()(Handle stored, Handle other) const { return stored.entry == other.entry; }
+        template<typename Q>
+        bool operator()(Handle stored, const Q& key) const { return equal((*entries)[stored.entry].key, key); }
+    };
+
+    using Index = ChainingHashTable<Handle, uint32_t, HandleHash, HandleEqual>;
+
+    std::vector<Entry> entries;
+    std::vector<uint32_t> freeEntries;   // места удалённых записей
+    Index index;
+    uint32_t head = NIL;
+    uint32_t tail = NIL;
+
+    size_t maxWeight;
+    size_t totalWeight = 0;
+    EvictionPolicy policy;
+    Weigher weigher;
+
+    size_t hitCount = 0;
+    size_t missCount = 0;
+    size_t evictionCount = 0;
+
+    Index makeIndex() { return Index(16, 0.9, HandleHash{&entries, Hash()}, HandleEqual{&entries, KeyEqual()}); }
+
+    void unlink(uint32_t i) {
+        Entry& entry = entries[i];
+        if (entry.prev != NIL) entries[entry.prev].next = entry.next;
+        else head = entry.next;
+        if (entry.next != NIL) entries[entry.next].prev = entry.prev;
+        else tail = entry.prev;
+    }
+
+    void pushFront(uint32_t i) {
+        entries[i].prev = NIL;
+        entries[i].next = head;
+        if (head != NIL) entries[head].prev = i;
+        else tail = i;
+        head = i;
+    }
+
+    void touch(uint32_t i) {
+        if (policy == EvictionPolicy::CLOCK) {
+            entries[i].referenced = true;
+        } else if (head != i) {
+            unlink(i);
+            pushFront(i);
+        }
+    }
+
+    // Запись в свободном месте пула или в новом; в индекс и список не входит
+    template<typename KK, typename VV>
+    uint32_t allocate(KK&& key, VV&& value) {
+        if (freeEntries.empty()) {
+            if (entries.size() >= NIL) throw std::length_error("LruCache: слишком много записей");
+            entries.emplace_back(std::forward<KK>(key), std::forward<VV>(value));
+            return static_cast<uint32_t>(entries.size() - 1);
+        }
+        uint32_t i = freeEntries.back();
+        freeEntries.pop_back();
+        entries[i] = Entry(std::forward<KK>(key), std::forward<VV>(value));
+        return i;
+    }
+
+    // Возвращает место в список свободных; ключ и значение освобождают память сразу
+    void release(uint32_t i) {
+        entries[i].key = K();
+        entries[i].value = V();
+        freeEntries.push_back(i);
+    }
+
+    void erase(uint32_t i) {
+        unlink(i);
+        totalWeight -= entries[i].weight;
+        index.remove(Handle{i});
+        release(i);
+    }
+
+    // Вытесняет записи с хвоста, пока вес не войдёт в ёмкость
+    void evict() {
+        while (totalWeight > maxWeight && tail != NIL) {
+            uint32_t victim = tail;
+            if (entries[victim].referenced) {
+                entries[victim].referenced = false;
+                unlink(victim);
+                pushFront(victim);
+                continue;
+            }
+            erase(victim);
+            evictionCount++;
+        }
+    }
+
+public:
+    explicit LruCache(size_t capacity, EvictionPolicy evictionPolicy = EvictionPolicy::LRU,
+                      const Weigher& weight = Weigher())
+        : index(makeIndex()), maxWeight(capacity), policy(evictionPolicy), weigher(weight) {
+        if (capacity == 0) throw std::invalid_argument("LruCache: capacity must be positive");
+    }
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    // Указатель на значение или nullptr; попадание обновляет давность записи.
+    // Указатель действителен до следующего put/remove
+    V* get(const K& key) {
+        uint32_t* i = index.lookup(key);
+        if (!i) {
+            missCount++;
+            return nullptr;
+        }
+        hitCount++;
+        touch(*i);
+        return &entries[*i].value;
+    }
+
+    bool get(const K& key, V& value) {
+        const V* found = get(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    // Проверка без обновления давности и счётчиков
+    bool contains(const K& key) const { return index.lookup(key) != nullptr; }
+
+    // Вставляет или заменяет значение и вытесняет лишнее. false - запись
+    // тяжелее всей ёмкости и не сохранена (старое значение ключа удаляется).
+    // Взвешиваются уже созданные K и V - те, что лежат в кеше, а не
+    // аргументы (например, const char* вместо std::string)
+    template<typename KK, typename VV>
+    bool put(KK&& key, VV&& value) {
+        if (uint32_t* found = index.lookup(static_cast<const K&>(key))) {
+            uint32_t existing = *found;
+            V fresh(std::forward<VV>(value));
+            size_t weight = weigher(entries[existing].key, fresh);
+            if (weight > maxWeight) {
+                erase(existing);
+                return false;
+            }
+            Entry& entry = entries[existing];
+            totalWeight = totalWeight - entry.weight + weight;
+            entry.value = std::move(fresh);
+            entry.weight = weight;
+            touch(existing);
+            evict();
+            return true;
+        }
+
+        uint32_t i = allocate(std::forward<KK>(key), std::forward<VV>(value));
+        size_t weight = weigher(entries[i].key, entries[i].value);
+        if (weight > maxWeight) {
+            release(i);
+            return false;
+        }
+        entries[i].weight = weight;
+        index.insert(Handle{i}, i);
+        pushFront(i);
+        totalWeight += weight;
+        evict();
+        return true;
+    }
+
+    bool remove(const K& key) {
+        const uint32_t* i = index.lookup(key);
+        if (!i) return false;
+        erase(*i);
+        return true;
+    }
+
+    void clear() {
+        entries.clear();
+        freeEntries.clear();
+        index = makeIndex();
+        head = tail = NIL;
+        totalWeight = 0;
+    }
+
+    // Новая ёмкость; лишнее вытесняется сразу
+    void setCapacity(size_t capacity) {
+        if (capacity == 0) throw std::invalid_argument("LruCache: capacity must be positive");
+        maxWeight = capacity;
+        evict();
+    }
+
+    // Ключи от самого свежего к самому старому (порядок списка давности)
+    template<typename F>
+    void forEach(F f) const {
+        for (uint32_t i = head; i != NIL; i = entries[i].next) f(entries[i].key, entries[i].value);
+    }
+
+    size_t size() const { return entries.size() - freeEntries.size(); }
+    bool isEmpty() const { return size() == 0; }
+    size_t weight() const { return totalWeight; }
+    size_t capacity() const { return maxWeight; }
+    EvictionPolicy getPolicy() const { return policy; }
+
+    size_t hits() const { return hitCount; }
+    size_t misses() const { return missCount; }
+    size_t evictions() const { return evictionCount; }
+    double hitRate() const {
+        size_t total = hitCount + missCount;
+        return total == 0 ? 0.0 : static_cast<double>(hitCount) / total;
+    }
+    void resetCounters() { hitCount = missCount = evictionCount = 0; }
+};
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef MAPPEDHASHTABLE_H
+#define MAPPEDHASHTABLE_H
+
+#include "hashTables.h"
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ==========================================================
+// 1. ОБРАЗ ТАБЛИЦЫ С ОТКРЫТОЙ АДРЕСАЦИЕЙ
+// ==========================================================
+// Образ не содержит указателей: заголовок, массив ячеек фиксированного
+// размера и область строк, на которую ячейки ссылаются смещениями.
+// Файл отображается в память (mmap) как есть, и find работает прямо по
+// отображению, без десериализации - открытие не зависит от числа записей.
+// Читать образ нужно тем же Hash и на той же платформе (порядок байт,
+// размеры типов): хеши записаны в ячейки и заново не считаются.
+
+// Строка в образе - смещение и длина в области строк
+struct SnapshotString {
+    uint64_t offset;
+    uint64_t length;
+};
+
+// Поле ячейки: тривиально копируемый тип хранится как есть, std::string - ссылкой
+template<typename T>
+struct SnapshotField {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshot supports trivially copyable types and std::string");
+    using type = T;
+};
+
+template<>
+struct SnapshotField<std::string> {
+    using type = SnapshotString;
+};
+
+template<typename K, typename V>
+struct SnapshotSlot {
+    uint64_t hash;
+    typename SnapshotField<K>::type key;
+    typename SnapshotField<V>::type value;
+    uint8_t occupied;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotSize;
+    uint64_t capacity;
+    uint64_t size;
+    uint64_t slotsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+constexpr char SNAPSHOT_MAGIC[8] = {'O', 'A', 'H', 'T', 'S', 'N', 'A', 'P'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// Кодирование полей при записи и чтение по отображению
+template<typename T>
+T encodeSnapshotField(const T& value, std::string&) { return value; }
+
+inline SnapshotString encodeSnapshotField(const std::string& value, std::string& strings) {
+    SnapshotString ref{strings.size(), value.size()};
+    strings += value;
+    return ref;
+}
+
+// Ссылка на строку проверяется на каждом чтении, а не при открытии:
+// обход всех ячеек сделал бы открытие зависимым от числа записей
+template<typename T>
+const T& snapshotView(const T& field, const char*, uint64_t) { return field; }
+
+inline std::string_view snapshotView(const SnapshotString& field, const char* strings, uint64_t stringsSize) {
+    if (field.offset > stringsSize || field.length > stringsSize - field.offset) {
+        throw std::runtime_error("MappedHashTable: string reference out of bounds");
+    }
+    return std::string_view(strings + field.offset, field.length);
+}
+
+// Доступ к внутреннему устройству OpenAddressingHashTable: обход живых
+// записей (включая ещё не перенесённые при постепенном rehash) и функция проб
+struct SnapshotAccess {
+    template<typename Table, typename F>
+    static void forEachEntry(const Table& table, F f) {
+        for (const auto* slots : {&table.table, &table.oldTable}) {
+            for (const auto& entry : *slots) {
+                if (entry.state == Table::EntryState::OCCUPIED) f(entry.key, entry.value, entry.hash);
+            }
+        }
+    }
+
+    template<typename Table>
+    static size_t probe(size_t h, size_t attempt, size_t capacity) {
+        return Table::probe(h, attempt, capacity);
+    }
+};
+
+// Записывает образ таблицы в файл path. Ячейки раскладываются заново по
+// сохранённым хешам, поэтому удалённые (DELETED) в образ не попадают
+template<typename K, typename V, typename Hash, typename KeyEqual>
+void saveSnapshot(const OpenAddressingHashTable<K, V, Hash, KeyEqual>& table, const std::string& path) {
+    using Table = OpenAddressingHashTable<K, V, Hash, KeyEqual>;
+    using Slot = SnapshotSlot<K, V>;
+
+    // Двойное хеширование обходит не все ячейки, если шаг не взаимно прост
+    // с ёмкостью; тогда, как и OpenAddressingHashTable, удваиваем ёмкость
+    size_t capacity = std::max<size_t>(table.getCapacity(), 2);
+    std::vector<Slot> slots;
+    std::string strings;
+    for (bool placed = false; !placed; capacity *= 2) {
+        slots.assign(capacity, Slot{});   // нулевая инициализация, вместе с выравниванием
+        strings.clear();
+        placed = true;
+        SnapshotAccess::forEachEntry(table, [&](const K& key, const V& value, size_t h) {
+            if (!placed) return;
+            for (size_t attempt = 0; attempt < capacity; ++attempt) {
+                Slot& slot = slots[SnapshotAccess::probe<Table>(h, attempt, capacity)];
+                if (slot.occupied) continue;
+                slot.hash = h;
+                slot.key = encodeSnapshotField(key, strings);
+                slot.value = encodeSnapshotField(value, strings);
+                slot.occupied = 1;
+                return;
+            }
+            placed = false;
+        });
+        if (placed) break;
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.slotSize = sizeof(Slot);
+    header.capacity = capacity;
+    header.size = table.getSize();
+    header.slotsOffset = 64;   // ячейки выровнены по кеш-линии
+    header.stringsOffset = header.slotsOffset + capacity * sizeof(Slot);
+    header.stringsSize = strings.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("saveSnapshot: cannot open " + path);
+    char padding[64] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding, header.slotsOffset - sizeof(header));
+    out.write(reinterpret_cast<const char*>(slots.data()), capacity * sizeof(Slot));
+    out.write(strings.data(), strings.size());
+    if (!out) throw std::runtime_error("saveSnapshot: write failed for " + path);
+}
+
+// ==========================================================
+// 2. ТАБЛИЦА ТОЛЬКО ДЛЯ ЧТЕНИЯ ПОВЕРХ ОТОБРАЖЁННОГО ОБРАЗА
+// ==========================================================
+// Пробирование то же, что у OpenAddressingHashTable, поэтому поиск
+// читает ровно те ячейки, что и исходная таблица. Страницы подгружаются
+// ядром по первому обращению и делятся между процессами.
+
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class MappedHashTable {
+private:
+    using Source = OpenAddressingHashTable<K, V, Hash, KeyEqual>;
+    using Slot = SnapshotSlot<K, V>;
+
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    const SnapshotHeader* header = nullptr;
+    const Slot* slots = nullptr;
+    const char* strings = nullptr;
+    Hash hasher;
+    KeyEqual equal;
+
+    void fail(const std::string& reason) {
+        if (mapping) munmap(mapping, mappingSize);
+        mapping = nullptr;
+        throw std::runtime_error("MappedHashTable: " + reason);
+    }
+
+    template<typename Q>
+    const Slot* findSlot(const Q& key) const {
+        size_t h = hasher(key);
+        size_t capacity = header->capacity;
+        for (size_t attempt = 0; attempt < capacity; ++attempt) {
+            const Slot& slot = slots[SnapshotAccess::probe<Source>(h, attempt, capacity)];
+            if (!slot.occupied) return nullptr;
+            if (slot.hash == h && equal(snapshotView(slot.key, strings, header->stringsSize), key)) return &slot;
+        }
+        return nullptr;
+    }
+
+    template<typename Q>
+    bool findImpl(const Q& key, V& value) const {
+        const Slot* slot = findSlot(key);
+        if (!slot) return false;
+        value = V(snapshotView(slot->value, strings, header->stringsSize));
+        return true;
+    }
+
+public:
+    explicit MappedHashTable(const std::string& path, const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : hasher(hash), equal(keyEqual) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail("cannot open " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+            close(fd);
+            fail("truncated image " + path);
+        }
+        mappingSize = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) fail("mmap failed for " + path);
+        mapping = address;
+        // Поиск обращается к случайным ячейкам - упреждающее чтение ядра не поможет
+        madvise(mapping, mappingSize, MADV_RANDOM);
+
+        header = static_cast<const SnapshotHeader*>(mapping);
+        if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) fail("bad magic in " + path);
+        if (header->version != SNAPSHOT_VERSION || header->slotSize != sizeof(Slot)) {
+            fail("incompatible image " + path);
+        }
+        // Границы сравниваются вычитанием из размера файла: сумма или
+        // произведение полей заголовка могли бы переполниться
+        if (header->capacity < 2 || header->size > header->capacity ||
+            header->slotsOffset < sizeof(SnapshotHeader) || header->slotsOffset % alignof(Slot) != 0 ||
+            header->slotsOffset > mappingSize ||
+            header->capacity > (mappingSize - header->slotsOffset) / sizeof(Slot) ||
+            header->stringsOffset != header->slotsOffset + header->capacity * sizeof(Slot) ||
+            header->stringsSize > mappingSize - header->stringsOffset) {
+            fail("corrupted image " + path);
+        }
+        slots = reinterpret_cast<const Slot*>(static_cast<const char*>(mapping) + header->slotsOffset);
+        strings = static_cast<const char*>(mapping) + header->stringsOffset;
+    }
+
+    ~MappedHashTable() {
+        if (mapping) munmap(mapping, mappingSize);
+    }
+
+    MappedHashTable(const MappedHashTable&) = delete;
+    MappedHashTable& operator=(const MappedHashTable&) = delete;
+
+    bool find(const K& key, V& value) const { return findImpl(key, value); }
+    bool contains(const K& key) const { return findSlot(key) != nullptr; }
+
+    // Прозрачный поиск по ключу другого типа (string_view, const char*)
+    template<typename Q, typename H = Hash, typename E = KeyEqual, typename = TransparentKey<H, E>>
+    bool find(const Q& key, V& value) const { return findImpl(key, value); }
+    template<typename Q, typename H = Hash, typename E = KeyEqual, typename = TransparentKey<H, E>>
+    bool contains(const Q& key) const { return findSlot(key) != nullptr; }
+
+    size_t getSize() const { return header->size; }
+    size_t getCapacity() const { return header->capacity; }
+    double loadFactor() const { return static_cast<double>(header->size) / header->capacity; }
+};
+
+#endif
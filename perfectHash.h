@@ -0,0 +1,301 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include "hashTables.h"
+#include <array>
+#include <numeric>
+
+// ==========================================================
+// 1. МИНИМАЛЬНОЕ СОВЕРШЕННОЕ ХЕШИРОВАНИЕ (hash-and-displace)
+// ==========================================================
+// Ключи делятся на корзины, в среднем по PERFECT_BUCKET_KEYS ключей.
+// Для каждой корзины, начиная с самых больших, подбирается пилот -
+// число, при котором все её ключи попадают в ещё свободные ячейки.
+// Ячеек ровно столько, сколько ключей, и поиск - это одна корзина,
+// один пилот и одна ячейка: без проб, надгробий и запаса по загрузке.
+// Если пилот не находится, построение повторяется с другим seed.
+// Таблица только для чтения: ключи известны заранее.
+
+constexpr size_t PERFECT_BUCKET_KEYS = 4;
+constexpr uint32_t PERFECT_MAX_SEEDS = 64;
+
+constexpr size_t perfectHashBuckets(size_t n) { return n / PERFECT_BUCKET_KEYS + 1; }
+
+constexpr size_t perfectHashBucket(uint64_t h, uint64_t seed, size_t buckets) {
+    return mixHash(h + seed) % buckets;
+}
+
+constexpr size_t perfectHashSlot(uint64_t h, uint64_t seed, uint32_t pilot, size_t n) {
+    return mixHash(h ^ mixHash(seed * 0x9E3779B97F4A7C15ull + pilot + 1)) % n;
+}
+
+template<typename K, typename V, typename Hash = DefaultHash<K>, typename KeyEqual = std::equal_to<>>
+class PerfectHashTable {
+private:
+    struct Slot {
+        K key;
+        V value;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> pilots;
+    uint64_t seed = 0;
+    Hash hasher;
+    KeyEqual equal;
+
+    // Подбирает пилоты для всех корзин при данном seed; false - не вышло
+    bool place(const std::vector<uint64_t>& hashes, std::vector<uint32_t>& slotOf) {
+        size_t n = hashes.size();
+        size_t buckets = perfectHashBuckets(n);
+        std::vector<uint32_t> bucketOf(n), order(n);
+        std::vector<uint32_t> start(buckets + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            bucketOf[i] = static_cast<uint32_t>(perfectHashBucket(hashes[i], seed, buckets));
+            start[bucketOf[i] + 1]++;
+        }
+        std::vector<uint32_t> byBucket(buckets);
+        std::iota(byBucket.begin(), byBucket.end(), 0);
+        std::stable_sort(byBucket.begin(), byBucket.end(),
+                         [&](uint32_t a, uint32_t b) { return start[a + 1] > start[b + 1]; });
+        for (size_t b = 0; b < buckets; ++b) start[b + 1] += start[b];
+        std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < n; ++i) order[fill[bucketOf[i]]++] = static_cast<uint32_t>(i);
+
+        // Перебор пилотов для последних корзин (по одному ключу на почти
+        // заполненную таблицу) в среднем занимает около n попыток
+        uint64_t maxPilot = 16 * static_cast<uint64_t>(n) + 1024;
+        std::vector<bool> taken(n, false);
+        std::vector<size_t> chosen;
+        pilots.assign(buckets, 0);
+        for (uint32_t b : byBucket) {
+            if (start[b] == start[b + 1]) break;   // дальше только пустые корзины
+            bool placed = false;
+            for (uint64_t pilot = 0; pilot < maxPilot && !placed; ++pilot) {
+                chosen.clear();
+                placed = true;
+                for (uint32_t k = start[b]; k < start[b + 1]; ++k) {
+                    size_t slot = perfectHashSlot(hashes[order[k]], seed, static_cast<uint32_t>(pilot), n);
+                    if (taken[slot]) {
+                        placed = false;
+                        break;
+                    }
+                    taken[slot] = true;
+                    chosen.push_back(slot);
+                }
+                if (!placed) {
+                    for (size_t slot : chosen) taken[slot] = false;
+                    continue;
+                }
+                pilots[b] = static_cast<uint32_t>(pilot);
+                for (size_t k = 0; k < chosen.size(); ++k) slotOf[order[start[b] + k]] = static_cast<uint32_t>(chosen[k]);
+            }
+            if (!placed) return false;
+        }
+        return true;
+    }
+
+    template<typename Q>
+    const V* lookupImpl(const Q& key) const {
+        if (slots.empty()) return nullptr;
+        uint64_t h = hasher(key);
+        uint32_t pilot = pilots[perfectHashBucket(h, seed, pilots.size())];
+        const Slot& slot = slots[perfectHashSlot(h, seed, pilot, slots.size())];
+        return equal(slot.key, key) ? &slot.value : nullptr;
+    }
+
+public:
+    // Строит таблицу по набору пар; повторяющийся ключ - invalid_argument
+    explicit PerfectHashTable(std::vector<std::pair<K, V>> entries, const Hash& hash = Hash(),
+                              const KeyEqual& keyEqual = KeyEqual())
+        : hasher(hash), equal(keyEqual) {
+        size_t n = entries.size();
+        if (n >= UINT32_MAX) throw std::length_error("PerfectHashTable: слишком много ключей");
+        std::vector<uint64_t> hashes(n);
+        for (size_t i = 0; i < n; ++i) hashes[i] = hasher(entries[i].first);
+
+        // Одинаковые ключи никогда не разойдутся по разным ячейкам - ищем их
+        // заранее среди ключей с совпадающим хешем
+        std::vector<uint32_t> byHash(n);
+        std::iota(byHash.begin(), byHash.end(), 0);
+        std::sort(byHash.begin(), byHash.end(), [&](uint32_t a, uint32_t b) { return hashes[a] < hashes[b]; });
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n && hashes[byHash[j]] == hashes[byHash[i]]; ++j) {
+                if (equal(entries[byHash[i]].first, entries[byHash[j]].first)) {
+                    throw std::invalid_argument("PerfectHashTable: duplicate key");
+                }
+            }
+        }
+        if (n == 0) return;
+
+        std::vector<uint32_t> slotOf(n);
+        while (!place(hashes, slotOf)) {
+            if (++seed == PERFECT_MAX_SEEDS) throw std::runtime_error("PerfectHashTable: no perfect hash found");
+        }
+
+        std::vector<uint32_t> entryAt(n);
+        for (size_t i = 0; i < n; ++i) entryAt[slotOf[i]] = static_cast<uint32_t>(i);
+        slots.reserve(n);
+        for (size_t s = 0; s < n; ++s) {
+            auto& entry = entries[entryAt[s]];
+            slots.push_back(Slot{std::move(entry.first), std::move(entry.second)});
+        }
+    }
+
+    // Снимок таблицы, у которой есть forEach(key, value): Chaining, OpenAddressing
+    template<typename Table>
+    static PerfectHashTable fromTable(const Table& table) {
+        std::vector<std::pair<K, V>> entries;
+        entries.reserve(table.getSize());
+        table.forEach([&](const K& key, const V& value) { entries.emplace_back(key, value); });
+        return PerfectHashTable(std::move(entries));
+    }
+
+    bool find(const K& key, V& value) const {
+        const V* found = lookupImpl(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+    bool contains(const K& key) const { return lookupImpl(key) != nullptr; }
+    const V* lookup(const K& key) const { return lookupImpl(key); }
+
+    // Прозрачный поиск по ключу другого типа (string_view, const char*)
+    template<typename Q, typename H = Hash, typename E = KeyEqual, typename = TransparentKey<H, E>>
+    bool contains(const Q& key) const { return lookupImpl(key) != nullptr; }
+    template<typename Q, typename H = Hash, typename E = KeyEqual, typename = TransparentKey<H, E>>
+    const V* lookup(const Q& key) const { return lookupImpl(key); }
+
+    size_t getSize() const { return slots.size(); }
+
+    // Пилоты - единственная служебная память, около 8 бит на ключ
+    size_t memoryUsage() const { return slots.capacity() * sizeof(Slot) + pilots.capacity() * sizeof(uint32_t); }
+};
+
+// ==========================================================
+// 2. СОВЕРШЕННЫЙ ХЕШ ВО ВРЕМЯ КОМПИЛЯЦИИ
+// ==========================================================
+// Для небольших фиксированных словарей (ключевые слова, коды команд):
+// тот же алгоритм, но на std::array и в constexpr, так что таблица
+// целиком лежит в образе программы. Перебор корзин квадратичный,
+// поэтому рассчитан на сотни ключей, не на тысячи. Повторяющийся ключ
+// или неудачное построение - ошибка компиляции.
+
+// Хеш, вычислимый при компиляции: FNV-1a для строк, splitmix64 для целых
+struct StaticKeyHash {
+    constexpr uint64_t operator()(std::string_view key) const {
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001B3ull;
+        }
+        return mixHash(h);
+    }
+
+    template<typename T, typename = std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value>>
+    constexpr uint64_t operator()(T key) const { return mixHash(static_cast<uint64_t>(key)); }
+};
+
+template<typename K, typename V, size_t N>
+class StaticPerfectHashTable {
+private:
+    static constexpr size_t BUCKETS = perfectHashBuckets(N);
+
+    std::array<K, N> keys{};
+    std::array<V, N> values{};
+    std::array<uint32_t, BUCKETS> pilots{};
+    uint64_t seed = 0;
+
+    constexpr bool place(const std::array<uint64_t, N>& hashes, std::array<size_t, N>& slotOf) {
+        std::array<size_t, N> bucketOf{};
+        std::array<size_t, BUCKETS> bucketSize{};
+        size_t largest = 0;
+        for (size_t i = 0; i < N; ++i) {
+            bucketOf[i] = perfectHashBucket(hashes[i], seed, BUCKETS);
+            largest = std::max(largest, ++bucketSize[bucketOf[i]]);
+        }
+
+        std::array<bool, N> taken{};
+        std::array<size_t, N> chosen{};
+        for (size_t size = largest; size > 0; --size) {
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                if (bucketSize[b] != size) continue;
+                bool placed = false;
+                for (uint32_t pilot = 0; pilot < 16 * N + 1024 && !placed; ++pilot) {
+                    size_t count = 0;
+                    placed = true;
+                    for (size_t i = 0; i < N && placed; ++i) {
+                        if (bucketOf[i] != b) continue;
+                        size_t slot = perfectHashSlot(hashes[i], seed, pilot, N);
+                        if (taken[slot]) {
+                            placed = false;
+                        } else {
+                            taken[slot] = true;
+                            slotOf[i] = slot;
+                            chosen[count++] = i;
+                        }
+                    }
+                    if (!placed) {
+                        for (size_t k = 0; k < count; ++k) taken[slotOf[chosen[k]]] = false;
+                    } else {
+                        pilots[b] = pilot;
+                    }
+                }
+                if (!placed) return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr size_t slotFor(uint64_t h) const {
+        return perfectHashSlot(h, seed, pilots[perfectHashBucket(h, seed, BUCKETS)], N);
+    }
+
+public:
+    constexpr explicit StaticPerfectHashTable(const std::pair<K, V> (&entries)[N]) {
+        std::array<uint64_t, N> hashes{};
+        for (size_t i = 0; i < N; ++i) {
+            hashes[i] = StaticKeyHash{}(entries[i].first);
+            for (size_t j = 0; j < i; ++j) {
+                if (entries[j].first == entries[i].first) throw std::invalid_argument("StaticPerfectHashTable: duplicate key");
+            }
+        }
+        std::array<size_t, N> slotOf{};
+        while (!place(hashes, slotOf)) {
+            if (++seed == PERFECT_MAX_SEEDS) throw std::runtime_error("StaticPerfectHashTable: no perfect hash found");
+        }
+        for (size_t i = 0; i < N; ++i) {
+            keys[slotOf[i]] = entries[i].first;
+            values[slotOf[i]] = entries[i].second;
+        }
+    }
+
+    constexpr const V* lookup(const K& key) const {
+        size_t slot = slotFor(StaticKeyHash{}(key));
+        return keys[slot] == key ? &values[slot] : nullptr;
+    }
+
+    constexpr bool contains(const K& key) const { return lookup(key) != nullptr; }
+
+    constexpr bool find(const K& key, V& value) const {
+        const V* found = lookup(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    // Значение или fallback - удобно в static_assert и switch
+    constexpr V get(const K& key, const V& fallback) const {
+        const V* found = lookup(key);
+        return found ? *found : fallback;
+    }
+
+    constexpr size_t getSize() const { return N; }
+};
+
+// Вывод N из списка: makeStaticPerfectHash<std::string_view, int>({{"if", 1}, {"else", 2}})
+template<typename K, typename V, size_t N>
+constexpr StaticPerfectHashTable<K, V, N> makeStaticPerfectHash(const std::pair<K, V> (&entries)[N]) {
+    return StaticPerfectHashTable<K, V, N>(entries);
+}
+
+#endif
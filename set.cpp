@@ -3,10 +3,12 @@
 #include <fstream>
 #include <functional>
 #include <algorithm>
+#include <stdexcept>
 
 using namespace std;
 
-Set::Set(int initialSize) : tableSize(initialSize), itemCount(0) {
+Set::Set(int initialSize)
+    : tableSize(initialSize), itemCount(0), maxLoad(0.7), minLoad(0.0), minTableSize(initialSize) {
     buckets = new NodeSet*[tableSize];
     for (int i = 0; i < tableSize; i++) {
         buckets[i] = nullptr;
@@ -23,27 +25,35 @@ int Set::hashFunction(int key) const {
     return hasher(key) % tableSize;
 }
 
+// Рост вдвое выше maxLoad, сжатие вдвое ниже minLoad. minLoad меньше
+// половины maxLoad, поэтому после сжатия набор не растёт обратно сразу
 void Set::rehashIfNeeded() {
     double loadFactor = static_cast<double>(itemCount) / tableSize;
-    if (loadFactor > 0.7) {
-        int oldSize = tableSize;
-        tableSize *= 2;
-        NodeSet** newBuckets = new NodeSet*[tableSize];
-        for (int i = 0; i < tableSize; i++) newBuckets[i] = nullptr;
-
-        for (int i = 0; i < oldSize; i++) {
-            NodeSet* current = buckets[i];
-            while (current) {
-                NodeSet* next = current->next;
-                int newIndex = hashFunction(current->key);
-                current->next = newBuckets[newIndex];
-                newBuckets[newIndex] = current;
-                current = next;
-            }
+    if (loadFactor > maxLoad) {
+        rebuild(tableSize * 2);
+    } else if (minLoad > 0 && tableSize > minTableSize && loadFactor < minLoad) {
+        rebuild(max(tableSize / 2, minTableSize));
+    }
+}
+
+void Set::rebuild(int newSize) {
+    int oldSize = tableSize;
+    tableSize = newSize;
+    NodeSet** newBuckets = new NodeSet*[tableSize];
+    for (int i = 0; i < tableSize; i++) newBuckets[i] = nullptr;
+
+    for (int i = 0; i < oldSize; i++) {
+        NodeSet* current = buckets[i];
+        while (current) {
+            NodeSet* next = current->next;
+            int newIndex = hashFunction(current->key);
+            current->next = newBuckets[newIndex];
+            newBuckets[newIndex] = current;
+            current = next;
         }
-        delete[] buckets;
-        buckets = newBuckets;
     }
+    delete[] buckets;
+    buckets = newBuckets;
 }
 
 bool Set::insert(int key) {
@@ -77,6 +87,7 @@ bool Set::remove(int key) {
             else prev->next = current->next;
             delete current;
             itemCount--;
+            rehashIfNeeded();
             return true;
         }
         prev = current;
@@ -100,6 +111,35 @@ void Set::clear() {
 
 int Set::size() const { return itemCount; }
 
+int Set::capacity() const { return tableSize; }
+
+// Наименьший размер таблицы, при котором n элементов не вызывают роста
+int Set::capacityFor(int n) const {
+    return static_cast<int>(n / maxLoad) + 1;
+}
+
+void Set::reserve(int n) {
+    int needed = capacityFor(n);
+    if (needed > tableSize) rebuild(needed);
+}
+
+void Set::shrinkToFit() {
+    rehash(0);
+}
+
+// Задаёт размер таблицы, но не меньше нужного для текущих элементов
+void Set::rehash(int newSize) {
+    rebuild(max(newSize, capacityFor(itemCount)));
+}
+
+void Set::setLoadFactors(double minLoadFactor, double maxLoadFactor) {
+    if (maxLoadFactor <= 0 || minLoadFactor < 0 || minLoadFactor * 2 >= maxLoadFactor) {
+        throw invalid_argument("setLoadFactors: need 0 <= 2 * minLoad < maxLoad");
+    }
+    minLoad = minLoadFactor;
+    maxLoad = maxLoadFactor;
+}
+
 bool Set::isEmpty() const { return itemCount == 0; }
 
 void Set::print() const {
@@ -14,10 +14,14 @@ private:
     NodeSet** buckets;
     int tableSize;
     int itemCount;
+    double maxLoad;      // порог роста
+    double minLoad;      // порог сжатия, 0 - не сжимать
+    int minTableSize;    // ниже начального размера автоматически не сжимаемся
 
     // Внутренние вспомогательные методы
     int hashFunction(int key) const;
     void rehashIfNeeded();
+    void rebuild(int newSize);
 
 public:
     // Конструктор и деструктор
@@ -32,6 +36,14 @@ public:
     bool isEmpty() const;
     void clear();
 
+    // Планирование ёмкости
+    int capacity() const;
+    int capacityFor(int n) const;
+    void reserve(int n);
+    void shrinkToFit();
+    void rehash(int newSize);
+    void setLoadFactors(double minLoadFactor, double maxLoadFactor);
+
     // Вспомогательные функции
     void print() const;
 
@@ -4,10 +4,18 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <map>
+#include <thread>
 #include "arrayOp.h"
 #include "stringOL.h"
 #include "fullBinaryTree.h"
 #include "hashTables.h"
+#include "concurrentHashTables.h"
+#include "mappedHashTable.h"
+#include "internedStrings.h"
+#include "lruCache.h"
+#include "perfectHash.h"
+#include "expiringHashTable.h"
 #include "queue.h"
 #include "set.h"
 #include "stack.h"
@@ -302,6 +310,11 @@ TEST(FBTCoverage, SubtreeComplex) {
     EXPECT_TRUE(mainTree.exists(80));
 }
 
+// Тождественный хеш: позволяет в тестах управлять коллизиями
+struct IdentityHash {
+    size_t operator()(int key) const { return static_cast<size_t>(key); }
+};
+
 class ChainingTest : public ::testing::Test {
 protected:
     ChainingHashTable<int, std::string> table;
@@ -344,6 +357,51 @@ TEST_F(ChainingTest, Getters) {
     EXPECT_DOUBLE_EQ(table.loadFactor(), 0.0);
 }
 
+TEST_F(ChainingTest, PooledChainsRemoveCompaction) {
+    ChainingHashTable<int, int, IdentityHash> t(4, 100.0);
+    // Длинные цепочки: ключи 0, 4, 8, ... попадают в одну ячейку
+    for (int i = 0; i < 32; ++i) t.insert(i, i * 10);
+    for (int i = 0; i < 32; i += 3) EXPECT_TRUE(t.remove(i));
+    int val;
+    for (int i = 0; i < 32; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_FALSE(t.find(i, val));
+        } else {
+            ASSERT_TRUE(t.find(i, val));
+            EXPECT_EQ(val, i * 10);
+        }
+    }
+    EXPECT_EQ(t.getSize(), 21);
+}
+
+// Байты на запись и время поиска для каждой таблицы на одних и тех же ключах.
+// Узел std::list<pair<int,int>> один стоит 24 байта + заголовок malloc,
+// а узел пула - 16 байт (с сохранённым хешем) плюс 4 байта на голову ячейки
+template<typename Table>
+double reportMemoryPerEntry(const char* name, int n) {
+    Table table;
+    std::vector<int> keys;
+    for (int i = 0; i < n; ++i) {
+        table.insert(i, i);
+        keys.push_back(i * 7 % n);
+    }
+    double perEntry = static_cast<double>(table.memoryUsage()) / table.getSize();
+    double findTime = table.measureFindTime(keys, 1);
+    std::cout << "[ MEMORY   ] " << name << ": " << perEntry << " bytes/entry, find x" << n << " "
+              << findTime * 1000 << " ms" << std::endl;
+    ::testing::Test::RecordProperty(std::string(name) + "_bytes_per_entry", std::to_string(perEntry));
+    return perEntry;
+}
+
+TEST(MemoryUsageTest, BytesPerEntryForEachTable) {
+    const int n = 100000;
+    EXPECT_LT((reportMemoryPerEntry<ChainingHashTable<int, int>>("chaining", n)), 32.0);
+    EXPECT_GT((reportMemoryPerEntry<OpenAddressingHashTable<int, int>>("open addressing", n)), 0.0);
+    EXPECT_GT((reportMemoryPerEntry<SwissHashTable<int, int>>("swiss", n)), 0.0);
+    EXPECT_GT((reportMemoryPerEntry<RobinHoodHashTable<int, int>>("robin hood", n)), 0.0);
+    EXPECT_GT((reportMemoryPerEntry<CuckooHashTable<int, int>>("cuckoo", n)), 0.0);
+}
+
 class OpenAddressingTest : public ::testing::Test {
 protected:
     OpenAddressingHashTable<int, std::string> table;
@@ -365,6 +423,8 @@ TEST_F(OpenAddressingTest, UpdateExisting) {
 }
 
 TEST_F(OpenAddressingTest, DeletedStateLogic) {
+    // DefaultHash разносит 1 и 17, для коллизии нужен тождественный хеш
+    OpenAddressingHashTable<int, std::string, IdentityHash> table;
     table.insert(1, "first");
     table.insert(17, "second"); // Коллизия (1%16 == 17%16)
     
@@ -387,6 +447,1825 @@ TEST_F(OpenAddressingTest, RecursiveRehashTrigger) {
     EXPECT_TRUE(smallTable.find(3, val));
 }
 
+class SwissTest : public ::testing::Test {
+protected:
+    SwissHashTable<int, std::string> table;
+};
+
+TEST_F(SwissTest, InsertFindUpdate) {
+    table.insert(1, "one");
+    table.insert(1, "uno");
+    std::string val;
+    EXPECT_TRUE(table.find(1, val));
+    EXPECT_EQ(val, "uno");
+    EXPECT_EQ(table.getSize(), 1);
+    EXPECT_FALSE(table.find(2, val));
+}
+
+TEST_F(SwissTest, PowerOfTwoCapacityAndGrowth) {
+    SwissHashTable<int, int> t(20);
+    EXPECT_EQ(t.getCapacity(), 32);
+    for (int i = 0; i < 1000; ++i) t.insert(i, i * 2);
+    EXPECT_EQ(t.getSize(), 1000);
+    EXPECT_EQ(t.getCapacity() & (t.getCapacity() - 1), 0);
+    EXPECT_LE(t.loadFactor(), 0.875);
+    int val;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(t.find(i, val));
+        EXPECT_EQ(val, i * 2);
+    }
+}
+
+TEST_F(SwissTest, RemoveAndChurn) {
+    SwissHashTable<int, int> t;
+    // Постоянные вставки/удаления не должны раздувать таблицу надгробиями
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 10; ++i) t.insert(round * 10 + i, i);
+        for (int i = 0; i < 10; ++i) EXPECT_TRUE(t.remove(round * 10 + i));
+    }
+    EXPECT_EQ(t.getSize(), 0);
+    EXPECT_LE(t.getCapacity(), 32);
+    int val;
+    EXPECT_FALSE(t.find(5, val));
+    EXPECT_FALSE(t.remove(5));
+}
+
+TEST_F(SwissTest, DisplayAndMeasureTime) {
+    table.insert(7, "seven");
+    testing::internal::CaptureStdout();
+    table.display();
+    std::string out = testing::internal::GetCapturedStdout();
+    EXPECT_NE(out.find("seven"), std::string::npos);
+    EXPECT_GE(table.measureFindTime({7, 8}, 1), 0.0);
+}
+
+TEST(RobinHoodTest, InsertFindUpdate) {
+    RobinHoodHashTable<int, std::string> table;
+    table.insert(1, "one");
+    table.insert(17, "collision");
+    table.insert(1, "uno");
+    std::string val;
+    EXPECT_TRUE(table.find(1, val));
+    EXPECT_EQ(val, "uno");
+    EXPECT_TRUE(table.find(17, val));
+    EXPECT_EQ(val, "collision");
+    EXPECT_FALSE(table.find(33, val));
+    EXPECT_EQ(table.getSize(), 2);
+}
+
+TEST(RobinHoodTest, BackwardShiftDeletion) {
+    RobinHoodHashTable<int, int, IdentityHash> table(16);
+    // Кластер из ключей с одной родной ячейкой
+    for (int i = 0; i < 5; ++i) table.insert(1 + 16 * i, i);
+    EXPECT_EQ(table.maxProbeLength(), 4);
+
+    EXPECT_TRUE(table.remove(1));
+    EXPECT_FALSE(table.remove(1));
+    // Хвост кластера сдвинут назад, надгробия не осталось
+    EXPECT_EQ(table.maxProbeLength(), 3);
+    int val;
+    for (int i = 1; i < 5; ++i) {
+        ASSERT_TRUE(table.find(1 + 16 * i, val));
+        EXPECT_EQ(val, i);
+    }
+}
+
+TEST(RobinHoodTest, ChurnKeepsProbesShort) {
+    RobinHoodHashTable<int, int> table(64);
+    for (int i = 0; i < 40; ++i) table.insert(i, i);
+    size_t before = table.maxProbeLength();
+    for (int round = 0; round < 1000; ++round) {
+        table.remove(round);
+        table.insert(round + 40, round);
+    }
+    EXPECT_EQ(table.getSize(), 40);
+    EXPECT_EQ(table.getCapacity(), 64);
+    EXPECT_LE(table.maxProbeLength(), before + 2);
+    int val;
+    EXPECT_FALSE(table.find(5, val));
+    EXPECT_TRUE(table.find(1030, val));
+}
+
+TEST(RobinHoodTest, GrowthAndDisplay) {
+    RobinHoodHashTable<int, std::string> table(2);
+    for (int i = 0; i < 100; ++i) table.insert(i, std::to_string(i));
+    std::string val;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(table.find(i, val));
+        EXPECT_EQ(val, std::to_string(i));
+    }
+    testing::internal::CaptureStdout();
+    table.display();
+    EXPECT_FALSE(testing::internal::GetCapturedStdout().empty());
+}
+
+TEST(HashPolicyTest, DefaultHashSpreadsSequentialIds) {
+    // Ключи, кратные 16, при тождественном хеше все попали бы в ячейку 0
+    std::vector<bool> used(16, false);
+    for (int i = 0; i < 64; ++i) used[DefaultHash<int>{}(i * 16) % 16] = true;
+    EXPECT_GT(std::count(used.begin(), used.end(), true), 8);
+}
+
+TEST(HashPolicyTest, TransparentStringLookup) {
+    ChainingHashTable<std::string, int> chain;
+    OpenAddressingHashTable<std::string, int> open;
+    SwissHashTable<std::string, int> swiss;
+    RobinHoodHashTable<std::string, int> robin;
+    chain.insert("alpha", 1);
+    open.insert("alpha", 1);
+    swiss.insert("alpha", 1);
+    robin.insert("alpha", 1);
+
+    std::string_view key = "alpha";
+    int val = 0;
+    EXPECT_TRUE(chain.find(key, val));
+    EXPECT_TRUE(open.find(key, val));
+    EXPECT_TRUE(swiss.find(key, val));
+    EXPECT_TRUE(robin.find("alpha", val));
+    EXPECT_EQ(val, 1);
+    EXPECT_FALSE(open.find(std::string_view("beta"), val));
+
+    EXPECT_TRUE(chain.remove(key));
+    EXPECT_TRUE(open.remove(key));
+    EXPECT_TRUE(swiss.remove("alpha"));
+    EXPECT_TRUE(robin.remove(key));
+    EXPECT_EQ(chain.getSize() + open.getSize() + swiss.getSize() + robin.getSize(), 0);
+}
+
+TEST(HashPolicyTest, CustomKeyEqual) {
+    // Регистронезависимые ключи через пользовательские Hash и KeyEqual
+    struct LowerHash {
+        size_t operator()(const std::string& s) const {
+            std::string lower(s);
+            for (auto& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return std::hash<std::string>{}(lower);
+        }
+    };
+    struct CaseInsensitiveEqual {
+        bool operator()(const std::string& a, const std::string& b) const {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+            });
+        }
+    };
+    OpenAddressingHashTable<std::string, int, LowerHash, CaseInsensitiveEqual> table;
+    table.insert("Key", 1);
+    table.insert("KEY", 2);
+    int val = 0;
+    EXPECT_TRUE(table.find(std::string("key"), val));
+    EXPECT_EQ(val, 2);
+    EXPECT_EQ(table.getSize(), 1);
+}
+
+// Семейства таблиц для типизированных наборов: общий тест пишется один
+// раз и получает таблицу нужных ключа и значения через TableOf
+struct ChainingTables {
+    static constexpr const char* name = "Chaining";
+    template<typename K, typename V, typename... Policy> using Table = ChainingHashTable<K, V, Policy...>;
+};
+struct OpenAddressingTables {
+    static constexpr const char* name = "OpenAddressing";
+    template<typename K, typename V, typename... Policy> using Table = OpenAddressingHashTable<K, V, Policy...>;
+};
+struct SwissTables {
+    static constexpr const char* name = "Swiss";
+    template<typename K, typename V, typename... Policy> using Table = SwissHashTable<K, V, Policy...>;
+};
+struct RobinHoodTables {
+    static constexpr const char* name = "RobinHood";
+    template<typename K, typename V, typename... Policy> using Table = RobinHoodHashTable<K, V, Policy...>;
+};
+struct CuckooTables {
+    static constexpr const char* name = "Cuckoo";
+    template<typename K, typename V, typename... Policy> using Table = CuckooHashTable<K, V, Policy...>;
+};
+
+template<typename Family, typename K, typename V, typename... Policy>
+using TableOf = typename Family::template Table<K, V, Policy...>;
+
+struct TableFamilyName {
+    template<typename Family>
+    static std::string GetName(int) { return Family::name; }
+};
+
+// Постепенный и параллельный rehash, пакетный поиск, итераторы, фильтр
+// Блума - у Chaining и OpenAddressing
+template<typename Family>
+class DynamicTableTest : public testing::Test {};
+using DynamicTables = testing::Types<ChainingTables, OpenAddressingTables>;
+TYPED_TEST_SUITE(DynamicTableTest, DynamicTables, TableFamilyName);
+
+// Планирование ёмкости и статистика - у всех таблиц
+template<typename Family>
+class AnyTableTest : public testing::Test {};
+using AllTables = testing::Types<ChainingTables, OpenAddressingTables, SwissTables, RobinHoodTables, CuckooTables>;
+TYPED_TEST_SUITE(AnyTableTest, AllTables, TableFamilyName);
+
+// Хеш, считающий свои вызовы: проверяем, что rehash не пересчитывает хеши
+struct CountingStringHash {
+    static size_t calls;
+    size_t operator()(const std::string& key) const {
+        calls++;
+        return std::hash<std::string>{}(key);
+    }
+};
+size_t CountingStringHash::calls = 0;
+
+TYPED_TEST(DynamicTableTest, HashesOncePerOperation) {
+    using Table = TableOf<TypeParam, std::string, int, CountingStringHash>;
+    Table table(4);
+    std::vector<std::string> keys;
+    for (int i = 0; i < 500; ++i) {
+        std::string key(64, 'k');   // длинные 64-байтовые ключи
+        std::string num = std::to_string(i);
+        key.replace(key.size() - num.size(), num.size(), num);
+        keys.push_back(key);
+    }
+    CountingStringHash::calls = 0;
+    for (size_t i = 0; i < keys.size(); ++i) table.insert(keys[i], static_cast<int>(i));
+    // Ровно одно вычисление хеша на вставку, несмотря на несколько rehash
+    EXPECT_EQ(CountingStringHash::calls, keys.size());
+    EXPECT_GT(table.getCapacity(), 4);
+
+    int val;
+    CountingStringHash::calls = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_TRUE(table.find(keys[i], val));
+        EXPECT_EQ(val, static_cast<int>(i));
+    }
+    EXPECT_EQ(CountingStringHash::calls, keys.size());
+    EXPECT_GE(table.measureFindTime(keys, 2), 0.0);
+}
+
+TEST(StoredHashTest, OpenAddressingReusesDeletedSlotWithoutDuplicates) {
+    OpenAddressingHashTable<int, std::string, IdentityHash> table;
+    table.insert(1, "first");
+    table.insert(17, "second");
+    table.remove(1);
+    // 17 стоит за надгробием - повторная вставка обновляет её, а не дублирует
+    table.insert(17, "updated");
+    EXPECT_EQ(table.getSize(), 1);
+    EXPECT_TRUE(table.remove(17));
+    std::string val;
+    EXPECT_FALSE(table.find(17, val));
+}
+
+TEST(StoredHashTest, OpenAddressingRehashKeepsEveryKey) {
+    // Шаг пробы не всегда взаимно прост с ёмкостью: при переносе ключ
+    // может не найти свободной ячейки, и тогда таблица растёт ещё раз
+    for (unsigned seed = 1; seed <= 8; ++seed) {
+        OpenAddressingHashTable<int, int> table;
+        std::mt19937 rng(seed);
+        std::vector<int> keys;
+        for (int i = 0; i < 2000; ++i) {
+            int key = static_cast<int>(rng());
+            keys.push_back(key);
+            table.insert(key, i);
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        EXPECT_EQ(table.getSize(), keys.size());
+        int val;
+        for (int key : keys) EXPECT_TRUE(table.find(key, val)) << "seed " << seed << ", key " << key;
+    }
+}
+
+TYPED_TEST(DynamicTableTest, IncrementalRehash) {
+    using Table = TableOf<TypeParam, int, int>;
+    Table table(16);
+    table.setIncrementalRehash(4);
+    bool sawRehashing = false;
+    int val;
+    for (int i = 0; i < 3000; ++i) {
+        table.insert(i, i);
+        if (table.isRehashing()) {
+            sawRehashing = true;
+            // Во время переноса видны ключи из обеих таблиц
+            ASSERT_TRUE(table.find(i / 2, val));
+            EXPECT_EQ(val, i / 2);
+            if (i % 5 == 0) {
+                EXPECT_TRUE(table.remove(i / 3));
+                table.insert(i / 3, i / 3);
+                table.insert(i / 2, -1);
+                EXPECT_TRUE(table.find(i / 2, val));
+                EXPECT_EQ(val, -1);
+                table.insert(i / 2, i / 2);
+            }
+        }
+    }
+    EXPECT_TRUE(sawRehashing);
+    EXPECT_EQ(table.getSize(), 3000);
+    for (int i = 0; i < 3000; ++i) {
+        ASSERT_TRUE(table.find(i, val));
+        EXPECT_EQ(val, i);
+    }
+
+    // Выключение режима завершает перенос
+    table.setIncrementalRehash(0);
+    EXPECT_FALSE(table.isRehashing());
+    for (int i = 3000; i < 6000; ++i) table.insert(i, i);
+    EXPECT_FALSE(table.isRehashing());
+    EXPECT_EQ(table.getSize(), 6000);
+}
+
+TEST(IncrementalRehashTest, DisplayShowsBothTables) {
+    ChainingHashTable<int, int> chain(4, 0.5);
+    OpenAddressingHashTable<int, int> open(4, 0.5);
+    chain.setIncrementalRehash(1);
+    open.setIncrementalRehash(1);
+    for (int i = 0; i < 3; ++i) {
+        chain.insert(i, i);
+        open.insert(i, i);
+    }
+    ASSERT_TRUE(chain.isRehashing());
+    ASSERT_TRUE(open.isRehashing());
+    testing::internal::CaptureStdout();
+    chain.display();
+    open.display();
+    std::string out = testing::internal::GetCapturedStdout();
+    EXPECT_NE(out.find("Старая ячейка"), std::string::npos);
+}
+
+TEST(IncrementalRehashTest, GrowthUsesPreparedTable) {
+    // Подготовленная таблица открытой адресации имеет простую ёмкость
+    auto isPrime = [](size_t x) {
+        for (size_t d = 2; d * d <= x; ++d) {
+            if (x % d == 0) return false;
+        }
+        return x > 1;
+    };
+    OpenAddressingHashTable<std::string, int> table(16);
+    table.setIncrementalRehash(2);
+    for (int i = 0; i < 20000; ++i) table.insert(std::to_string(i), i);
+    EXPECT_TRUE(isPrime(table.getCapacity())) << table.getCapacity();
+    EXPECT_GT(table.stats().rehashCount, 5u);
+    int value = 0;
+    for (int i = 0; i < 20000; ++i) ASSERT_TRUE(table.find(std::to_string(i), value)) << i;
+
+    table.setIncrementalRehash(0);
+    EXPECT_FALSE(table.isRehashing());
+    EXPECT_EQ(table.getSize(), 20000u);
+}
+
+TEST(ConcurrentChainingTest, SingleThreadSemantics) {
+    ConcurrentChainingHashTable<std::string, int> table(16, 0.9, 6);
+    EXPECT_EQ(table.getSegmentCount(), 8);
+    table.insert("a", 1);
+    table.insert("a", 2);
+    int val = 0;
+    EXPECT_TRUE(table.find(std::string_view("a"), val));
+    EXPECT_EQ(val, 2);
+    EXPECT_EQ(table.getSize(), 1);
+    EXPECT_TRUE(table.remove("a"));
+    EXPECT_FALSE(table.remove("a"));
+    EXPECT_EQ(table.getSize(), 0);
+}
+
+TEST(ConcurrentChainingTest, ParallelWritersAndReaders) {
+    ConcurrentChainingHashTable<int, int> table(64, 0.9, 16);
+    const int threads = 8, perThread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&table, t]() {
+            int val;
+            for (int i = 0; i < perThread; ++i) {
+                int key = t * perThread + i;
+                table.insert(key, key);
+                // Читаем свои и чужие ключи, пока сегменты растут
+                if (table.find(key, val)) {
+                    EXPECT_EQ(val, key);
+                }
+                table.find((key * 31) % (threads * perThread), val);
+                if (i % 4 == 0) table.remove(key);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    EXPECT_EQ(table.getSize(), static_cast<size_t>(threads * perThread * 3 / 4));
+    int val;
+    for (int key = 0; key < threads * perThread; ++key) {
+        EXPECT_EQ(table.find(key, val), key % perThread % 4 != 0);
+    }
+    EXPECT_GT(table.getCapacity(), 64);
+    EXPECT_LE(table.loadFactor(), 0.9);
+}
+
+TEST(ConcurrentChainingTest, MeasureConcurrentTimeAndDisplay) {
+    ConcurrentChainingHashTable<int, int> table;
+    std::vector<int> keys;
+    for (int i = 0; i < 1000; ++i) {
+        keys.push_back(i);
+        table.insert(i, i);
+    }
+    EXPECT_GE(measureConcurrentTime(table, keys, 4, 10000, 10), 0.0);
+    EXPECT_EQ(table.getSize(), 1000);
+
+    testing::internal::CaptureStdout();
+    table.display();
+    EXPECT_NE(testing::internal::GetCapturedStdout().find("Сегмент"), std::string::npos);
+}
+
+TEST(ReaderSlotsMutexTest, WritersExcludeReaders) {
+    // Писатели меняют пару чисел под блокировкой, читатели всегда видят её целой
+    ReaderSlotsMutex lock;
+    int first = 0, second = 0;
+    std::atomic<bool> torn{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 6; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < 3000; ++i) {
+                if (t < 2) {
+                    std::unique_lock<ReaderSlotsMutex> guard(lock);
+                    first++;
+                    second++;
+                } else {
+                    std::shared_lock<ReaderSlotsMutex> guard(lock);
+                    if (first != second) torn = true;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    EXPECT_FALSE(torn);
+    EXPECT_EQ(first, 6000);
+    EXPECT_EQ(second, 6000);
+}
+
+TEST(AtomicHashTableTest, BasicSemantics) {
+    AtomicHashTable<int, int> table(16);
+    table.insert(1, 10);
+    table.insert(1, 11);
+    int val = 0;
+    EXPECT_TRUE(table.find(1, val));
+    EXPECT_EQ(val, 11);
+    EXPECT_EQ(table.getSize(), 1);
+    EXPECT_TRUE(table.remove(1));
+    EXPECT_FALSE(table.remove(1));
+    EXPECT_FALSE(table.find(1, val));
+    table.insert(1, 12);
+    EXPECT_TRUE(table.find(1, val));
+    EXPECT_EQ(val, 12);
+
+    // Служебные значения ключа вставить нельзя
+    EXPECT_THROW(table.insert(std::numeric_limits<int>::max(), 0), std::invalid_argument);
+    EXPECT_FALSE(table.find(std::numeric_limits<int>::max(), val));
+}
+
+TEST(AtomicHashTableTest, CooperativeGrowth) {
+    int payload[4] = {0, 1, 2, 3};
+    AtomicHashTable<long, int*> table(16);
+    for (long i = 0; i < 5000; ++i) table.insert(i, &payload[i % 4]);
+    EXPECT_EQ(table.getSize(), 5000);
+    EXPECT_GE(table.getCapacity(), 5000);
+    EXPECT_LE(table.loadFactor(), 0.8);
+    int* val = nullptr;
+    for (long i = 0; i < 5000; ++i) {
+        ASSERT_TRUE(table.find(i, val));
+        EXPECT_EQ(val, &payload[i % 4]);
+    }
+    // Удалённые ключи отбрасываются при переносе, старые массивы освобождаются
+    for (long i = 0; i < 5000; i += 2) EXPECT_TRUE(table.remove(i));
+    for (long i = 5000; i < 20000; ++i) table.insert(i, nullptr);
+    table.reclaim();
+    EXPECT_EQ(table.getSize(), 17500);
+    EXPECT_FALSE(table.find(0, val));
+    EXPECT_TRUE(table.find(1, val));
+}
+
+TEST(AtomicHashTableTest, ConcurrentStress) {
+    AtomicHashTable<int, int> table(64);
+    const int threads = 8, range = 4000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&table, t]() {
+            int val;
+            for (int i = 0; i < range; ++i) {
+                // Все потоки пишут одни и те же ключи во время совместного
+                // роста таблицы - дубликатов быть не должно
+                table.insert(i, i);
+                if (table.find(i, val)) {
+                    EXPECT_EQ(val, i);
+                }
+                if ((i + t) % 7 == 0) table.remove(i);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    size_t present = 0;
+    int val;
+    for (int i = 0; i < range; ++i) {
+        if (table.find(i, val)) {
+            present++;
+            EXPECT_EQ(val, i);
+        }
+    }
+    EXPECT_EQ(table.getSize(), present);
+
+    std::vector<int> keys(range);
+    for (int i = 0; i < range; ++i) keys[i] = i;
+    EXPECT_GE(measureConcurrentTime(table, keys, 4, 10000, 8), 0.0);
+
+    testing::internal::CaptureStdout();
+    table.display();
+    EXPECT_FALSE(testing::internal::GetCapturedStdout().empty());
+}
+
+TEST(AtomicHashTableTest, ReadersDuringUpdatesAndGrowth) {
+    AtomicHashTable<int, int> table(16);
+    table.insert(0, 0);
+    const int updates = 20000;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&table, &done]() {
+            // Перезапись и перенос ключа не прячут его от читателя, а
+            // значения не идут назад
+            int last = 0, val = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                ASSERT_TRUE(table.find(0, val));
+                EXPECT_GE(val, last);
+                last = val;
+            }
+        });
+    }
+    for (int v = 1; v <= updates; ++v) {
+        table.insert(0, v);
+        table.insert(v, v);   // рост таблицы: ключ 0 переносится много раз
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) reader.join();
+    int val = 0;
+    EXPECT_TRUE(table.find(0, val));
+    EXPECT_EQ(val, updates);
+    EXPECT_EQ(table.getSize(), static_cast<size_t>(updates) + 1);
+}
+
+// Обновления и удаления, шедшие во время переноса, не теряются и
+// удалённые ключи не воскресают: у каждого потока свои ключи, а таблица
+// растёт с 16 ячеек много раз подряд
+TEST(AtomicHashTableTest, NoLostUpdatesDuringGrowth) {
+    AtomicHashTable<int, int> table(16);
+    const int threads = 4, keys = 3000, rounds = 3;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&table, t]() {
+            for (int round = 1; round <= rounds; ++round) {
+                for (int i = t; i < keys; i += threads) table.insert(i, i * 10 + round);
+                for (int i = t; i < keys; i += threads) {
+                    if (i % 3 == 0) {
+                        EXPECT_TRUE(table.remove(i)) << i;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    int val = 0;
+    size_t present = 0;
+    for (int i = 0; i < keys; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_FALSE(table.find(i, val)) << i;
+            continue;
+        }
+        ASSERT_TRUE(table.find(i, val)) << i;
+        EXPECT_EQ(val, i * 10 + rounds);
+        present++;
+    }
+    EXPECT_EQ(table.getSize(), present);
+}
+
+TEST(AtomicHashTableTest, ValueEncoding) {
+    // Значение занимает младшие 32 бита слова, признак - старшие
+    AtomicHashTable<long, int> numbers(16);
+    numbers.insert(-1, -1);
+    numbers.insert(2, std::numeric_limits<int>::min());
+    int val = 0;
+    EXPECT_TRUE(numbers.find(-1, val));
+    EXPECT_EQ(val, -1);
+    EXPECT_TRUE(numbers.find(2, val));
+    EXPECT_EQ(val, std::numeric_limits<int>::min());
+
+    // У указателя признак - в двух младших битах
+    alignas(4) char bytes[8] = {};
+    AtomicHashTable<int, char*> pointers(16);
+    pointers.insert(1, bytes);
+    pointers.insert(2, nullptr);
+    EXPECT_THROW(pointers.insert(3, bytes + 1), std::invalid_argument);
+    char* found = bytes + 4;
+    EXPECT_TRUE(pointers.find(2, found));
+    EXPECT_EQ(found, nullptr);
+    EXPECT_TRUE(pointers.find(1, found));
+    EXPECT_EQ(found, bytes);
+    EXPECT_FALSE(pointers.find(3, found));
+    EXPECT_EQ(pointers.getSize(), 2u);
+}
+
+TEST(ShardedHashTableTest, SingleAndBatchOperations) {
+    ShardedHashTable<int, std::string, OpenAddressingHashTable<int, std::string>> table(4, 64);
+    EXPECT_EQ(table.getShardCount(), 4);
+    table.insert(1, "one");
+    std::vector<std::pair<int, std::string>> items;
+    for (int i = 2; i < 200; ++i) items.emplace_back(i, std::to_string(i));
+    table.insertBatch(items.data(), items.size());
+    EXPECT_EQ(table.getSize(), 199);
+
+    // Ключи распределены по всем шардам
+    for (size_t s = 0; s < table.getShardCount(); ++s) EXPECT_GT(table.getShardSize(s), 0);
+
+    int keys[] = {1, 50, 199, 500};
+    std::string values[4];
+    bool found[4];
+    EXPECT_EQ(table.findBatch(keys, 4, values, found), 3);
+    EXPECT_EQ(values[0], "one");
+    EXPECT_EQ(values[1], "50");
+    EXPECT_TRUE(found[2]);
+    EXPECT_FALSE(found[3]);
+
+    int removed[] = {1, 2, 3, 1000};
+    EXPECT_EQ(table.removeBatch(removed, 4), 3);
+    std::string val;
+    EXPECT_FALSE(table.find(2, val));
+    EXPECT_TRUE(table.remove(4));
+    EXPECT_EQ(table.getSize(), 195);
+    EXPECT_GT(table.loadFactor(), 0.0);
+
+    testing::internal::CaptureStdout();
+    table.display();
+    EXPECT_NE(testing::internal::GetCapturedStdout().find("Шард"), std::string::npos);
+}
+
+TEST(ShardedHashTableTest, ParallelWriters) {
+    ShardedHashTable<int, int, SwissHashTable<int, int>> table(8);
+    const int threads = 8, perThread = 3000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&table, t]() {
+            for (int i = 0; i < perThread; ++i) table.insert(t * perThread + i, i);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    EXPECT_EQ(table.getSize(), static_cast<size_t>(threads * perThread));
+
+    std::vector<int> keys;
+    for (int i = 0; i < threads * perThread; ++i) keys.push_back(i);
+    EXPECT_GE(measureConcurrentTime(table, keys, 4, 5000, 4), 0.0);
+}
+
+TEST(SegmentedHashTableTest, LockPolicies) {
+    // Тот же набор операций над сегментами с разными блокировками
+    ShardedHashTable<int, int, OpenAddressingHashTable<int, int>, DefaultHash<int>, std::shared_mutex> shared(4);
+    ConcurrentChainingHashTable<int, int> readerSlots(64, 0.9, 4);
+    std::vector<std::pair<int, int>> items;
+    for (int i = 0; i < 100; ++i) items.emplace_back(i, i * 2);
+    shared.insertBatch(items.data(), items.size());
+    readerSlots.insertBatch(items.data(), items.size());
+
+    int keys[] = {7, 99, 100};
+    int values[3] = {};
+    bool found[3];
+    EXPECT_EQ(shared.findBatch(keys, 3, values, found), 2);
+    EXPECT_EQ(values[0], 14);
+    EXPECT_FALSE(found[2]);
+    EXPECT_EQ(readerSlots.findBatch(keys, 3, values, found), 2);
+    EXPECT_EQ(values[1], 198);
+    EXPECT_EQ(readerSlots.removeBatch(keys, 3), 2);
+    EXPECT_EQ(readerSlots.getSize(), 98);
+    EXPECT_EQ(readerSlots.getSegmentCount(), 4);
+}
+
+// Значение, считающее свои копирования и перемещения
+struct CopyCounter {
+    static int copies;
+    static int moves;
+    std::string payload;
+
+    CopyCounter() = default;
+    explicit CopyCounter(std::string data) : payload(std::move(data)) {}
+    CopyCounter(const CopyCounter& other) : payload(other.payload) { copies++; }
+    CopyCounter(CopyCounter&& other) noexcept : payload(std::move(other.payload)) { moves++; }
+    CopyCounter& operator=(const CopyCounter& other) {
+        payload = other.payload;
+        copies++;
+        return *this;
+    }
+    CopyCounter& operator=(CopyCounter&& other) noexcept {
+        payload = std::move(other.payload);
+        moves++;
+        return *this;
+    }
+};
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+
+std::ostream& operator<<(std::ostream& out, const CopyCounter& value) {
+    return out << value.payload;
+}
+
+TYPED_TEST(DynamicTableTest, CopyFreeApi) {
+    using Table = TableOf<TypeParam, int, CopyCounter>;
+    Table table(4);
+    std::string big(4096, 'x');
+    CopyCounter::copies = 0;
+    for (int i = 0; i < 100; ++i) {
+        // Перемещение значения и создание из аргументов (у цепочек - прямо
+        // в узле, у открытой адресации - с одним перемещением в ячейку):
+        // ни одной копии, даже при rehash
+        table.insertOrAssign(i, CopyCounter(big));
+        table.tryEmplace(i + 1000, big);
+    }
+    EXPECT_EQ(CopyCounter::copies, 0);
+
+    // Горячий путь: поиск по указателю не копирует значение
+    for (int i = 0; i < 100; ++i) {
+        const CopyCounter* found = table.lookup(i);
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(found->payload.size(), 4096);
+    }
+    EXPECT_EQ(table.lookup(5000), nullptr);
+    EXPECT_EQ(CopyCounter::copies, 0);
+
+    // tryEmplace не трогает существующее значение, insertOrAssign заменяет
+    auto [value, inserted] = table.tryEmplace(1, "ignored");
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(value->payload, big);
+    auto [assigned, fresh] = table.insertOrAssign(1, CopyCounter("new"));
+    EXPECT_FALSE(fresh);
+    EXPECT_EQ(assigned->payload, "new");
+    table.lookup(2)->payload = "edited";
+    EXPECT_EQ(table.lookup(2)->payload, "edited");
+    EXPECT_EQ(CopyCounter::copies, 0);
+    EXPECT_EQ(table.getSize(), 200);
+}
+
+TEST(CopyFreeApiTest, TransparentLookup) {
+    ChainingHashTable<std::string, int> chain;
+    OpenAddressingHashTable<std::string, int> open;
+    chain.insertOrAssign(std::string("key"), 1);
+    open.tryEmplace("key", 2);
+    ASSERT_NE(chain.lookup(std::string_view("key")), nullptr);
+    EXPECT_EQ(*chain.lookup(std::string_view("key")), 1);
+    EXPECT_EQ(*open.lookup("key"), 2);
+    EXPECT_EQ(open.lookup("nope"), nullptr);
+}
+
+TEST(StaticDispatchTest, TablesAreFinal) {
+    EXPECT_TRUE((std::is_final<ChainingHashTable<int, int>>::value));
+    EXPECT_TRUE((std::is_final<OpenAddressingHashTable<int, int>>::value));
+    EXPECT_TRUE((std::is_final<SwissHashTable<int, int>>::value));
+    EXPECT_TRUE((std::is_final<RobinHoodHashTable<int, int>>::value));
+    // Без адаптера у таблиц нет vtable
+    EXPECT_FALSE((std::is_polymorphic<ChainingHashTable<int, int>>::value));
+    EXPECT_FALSE((std::is_polymorphic<RobinHoodHashTable<int, int>>::value));
+}
+
+TEST(StaticDispatchTest, PolymorphicAdapter) {
+    std::vector<std::unique_ptr<HashTable<int, std::string>>> tables;
+    tables.emplace_back(new PolymorphicHashTable<ChainingHashTable<int, std::string>>(8));
+    tables.emplace_back(new PolymorphicHashTable<OpenAddressingHashTable<int, std::string>>(8, 0.5));
+    tables.emplace_back(new PolymorphicHashTable<SwissHashTable<int, std::string>>());
+    tables.emplace_back(new PolymorphicHashTable<RobinHoodHashTable<int, std::string>>());
+
+    for (auto& table : tables) {
+        for (int i = 0; i < 50; ++i) table->insert(i, std::to_string(i));
+        std::string value;
+        EXPECT_TRUE(table->find(42, value));
+        EXPECT_EQ(value, "42");
+        EXPECT_TRUE(table->remove(42));
+        EXPECT_FALSE(table->find(42, value));
+        EXPECT_EQ(table->getSize(), 49);
+        EXPECT_GT(table->loadFactor(), 0.0);
+    }
+
+    PolymorphicHashTable<ChainingHashTable<int, std::string>> wrapped;
+    wrapped.insert(1, "one");
+    EXPECT_EQ(*wrapped.get().lookup(1), "one");
+}
+
+TYPED_TEST(DynamicTableTest, FindBatch) {
+    using Table = TableOf<TypeParam, int, int>;
+    Table table(8);
+    table.setIncrementalRehash(4);
+    for (int i = 0; i < 1000; ++i) table.insert(i * 2, i);
+    for (int i = 0; i < 100; ++i) table.remove(i * 2);
+    EXPECT_EQ(table.getSize(), 900);
+
+    // Чётные ключи (кроме удалённых) есть, нечётные - промахи;
+    // 37 ключей - группы не кратны размеру пакета
+    std::vector<int> keys;
+    for (int i = 0; i < 37 * 20; ++i) keys.push_back(i * 3 % 2001);
+    std::vector<const int*> values(keys.size());
+    const Table& view = table;
+    view.findBatch(keys.data(), keys.size(), values.data());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(values[i], view.lookup(keys[i])) << keys[i];
+        bool present = keys[i] % 2 == 0 && keys[i] >= 200;
+        ASSERT_EQ(values[i] != nullptr, present) << keys[i];
+        if (present) {
+            EXPECT_EQ(*values[i], keys[i] / 2);
+        }
+    }
+
+    // Неконстантная версия даёт изменяемые указатели
+    std::vector<int*> mutableValues(3);
+    int some[] = {200, 1, 202};
+    table.findBatch(some, 3, mutableValues.data());
+    ASSERT_NE(mutableValues[0], nullptr);
+    EXPECT_EQ(mutableValues[1], nullptr);
+    *mutableValues[2] = -1;
+    EXPECT_EQ(*table.lookup(202), -1);
+    table.findBatch(some, 0, mutableValues.data());
+}
+
+TEST(MappedHashTableTest, IntRoundTrip) {
+    const std::string imageFile = "oa_int.snap";
+    OpenAddressingHashTable<int, int> table(8);
+    table.setIncrementalRehash(2);
+    for (int i = 0; i < 500; ++i) table.insert(i, i * i);
+    for (int i = 0; i < 500; i += 5) table.remove(i);
+    table.rehash(table.getCapacity() * 2);   // перенос порциями только начался
+    EXPECT_TRUE(table.isRehashing());
+    saveSnapshot(table, imageFile);
+
+    {
+        MappedHashTable<int, int> mapped(imageFile);
+        EXPECT_EQ(mapped.getSize(), table.getSize());
+        EXPECT_GE(mapped.getCapacity(), table.getCapacity());
+        int value = 0;
+        for (int i = 0; i < 500; ++i) {
+            EXPECT_EQ(mapped.find(i, value), i % 5 != 0) << i;
+            if (i % 5 != 0) {
+                EXPECT_EQ(value, i * i);
+            }
+        }
+        EXPECT_FALSE(mapped.contains(-1));
+        EXPECT_FALSE(mapped.contains(1000));
+    }
+    std::remove(imageFile.c_str());
+}
+
+TEST(MappedHashTableTest, StringRoundTrip) {
+    const std::string imageFile = "oa_string.snap";
+    OpenAddressingHashTable<std::string, std::string> table;
+    for (int i = 0; i < 100; ++i) table.insert("key" + std::to_string(i), std::string(i, 'v'));
+    table.insert("", "empty key");
+    saveSnapshot(table, imageFile);
+
+    {
+        MappedHashTable<std::string, std::string> mapped(imageFile);
+        std::string value;
+        EXPECT_TRUE(mapped.find(std::string("key42"), value));
+        EXPECT_EQ(value, std::string(42, 'v'));
+        // Прозрачный поиск прямо по отображению, без временной std::string
+        EXPECT_TRUE(mapped.find(std::string_view("key7"), value));
+        EXPECT_EQ(value, "vvvvvvv");
+        EXPECT_TRUE(mapped.find("", value));
+        EXPECT_EQ(value, "empty key");
+        EXPECT_FALSE(mapped.contains("key100"));
+        EXPECT_EQ(mapped.getSize(), 101);
+    }
+    std::remove(imageFile.c_str());
+}
+
+TEST(MappedHashTableTest, RejectsInvalidImages) {
+    const std::string badFile = "bad.snap";
+    EXPECT_THROW((MappedHashTable<int, int>("missing.snap")), std::runtime_error);
+    {
+        std::ofstream out(badFile, std::ios::binary);
+        out << "not a snapshot at all, just some bytes to fill the header area....";
+    }
+    EXPECT_THROW((MappedHashTable<int, int>(badFile)), std::runtime_error);
+
+    // Образ другой специализации - размер ячейки не совпадает
+    OpenAddressingHashTable<int, int> table;
+    table.insert(1, 1);
+    saveSnapshot(table, badFile);
+    EXPECT_THROW((MappedHashTable<int, double>(badFile)), std::runtime_error);
+
+    // Ёмкость, при которой capacity * sizeof(Slot) переполняется
+    {
+        std::fstream patch(badFile, std::ios::binary | std::ios::in | std::ios::out);
+        uint64_t capacity = (UINT64_MAX / sizeof(SnapshotSlot<int, int>)) + 2;
+        patch.seekp(offsetof(SnapshotHeader, capacity));
+        patch.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+    }
+    EXPECT_THROW((MappedHashTable<int, int>(badFile)), std::runtime_error);
+
+    // Ссылка ячейки на строку за пределами области строк
+    using StringSlot = SnapshotSlot<std::string, std::string>;
+    OpenAddressingHashTable<std::string, std::string> strings;
+    strings.insert("key", "value");
+    saveSnapshot(strings, badFile);
+    {
+        std::fstream patch(badFile, std::ios::binary | std::ios::in | std::ios::out);
+        SnapshotHeader header;
+        patch.read(reinterpret_cast<char*>(&header), sizeof(header));
+        for (uint64_t i = 0; i < header.capacity; ++i) {
+            StringSlot slot;
+            uint64_t at = header.slotsOffset + i * sizeof(StringSlot);
+            patch.seekg(at);
+            patch.read(reinterpret_cast<char*>(&slot), sizeof(slot));
+            if (!slot.occupied) continue;
+            slot.value.length = header.stringsSize + 1;
+            patch.seekp(at);
+            patch.write(reinterpret_cast<const char*>(&slot), sizeof(slot));
+        }
+    }
+    {
+        MappedHashTable<std::string, std::string> mapped(badFile);
+        std::string value;
+        EXPECT_TRUE(mapped.contains("key"));
+        EXPECT_THROW(mapped.find("key", value), std::runtime_error);
+    }
+    std::remove(badFile.c_str());
+}
+
+TYPED_TEST(AnyTableTest, CapacityPlanning) {
+    using Table = TableOf<TypeParam, int, int>;
+    Table table(16);
+    // Заранее выделенное место: вставка 5000 элементов без единого rehash
+    table.reserve(5000);
+    size_t reserved = table.getCapacity();
+    EXPECT_GE(reserved, 5000);
+    for (int i = 0; i < 5000; ++i) table.insert(i, i);
+    EXPECT_EQ(table.getCapacity(), reserved);
+
+    // Массовое удаление без минимального порога ёмкость не трогает
+    for (int i = 0; i < 4900; ++i) table.remove(i);
+    EXPECT_EQ(table.getCapacity(), reserved);
+
+    table.shrinkToFit();
+    EXPECT_LT(table.getCapacity(), 1000);
+    EXPECT_LE(table.loadFactor(), table.maxLoadFactor());
+    int value = 0;
+    for (int i = 4900; i < 5000; ++i) {
+        ASSERT_TRUE(table.find(i, value)) << i;
+        EXPECT_EQ(value, i);
+    }
+
+    // rehash(n) не опускается ниже нужного для текущих элементов
+    table.rehash(1);
+    EXPECT_GE(table.getCapacity(), 100);
+    table.rehash(4096);
+    EXPECT_GE(table.getCapacity(), 4096);
+
+    // Гистерезис: сжатие при заполненности ниже 0.2, рост - выше 0.8
+    EXPECT_THROW(table.setLoadFactors(0.5, 0.8), std::invalid_argument);
+    table.setLoadFactors(0.2, 0.8);
+    for (int i = 0; i < 10000; ++i) table.insert(i, i);
+    size_t grown = table.getCapacity();
+    for (int i = 0; i < 9990; ++i) table.remove(i);
+    EXPECT_LT(table.getCapacity(), grown / 8);
+    EXPECT_GE(table.loadFactor(), 0.1);
+    EXPECT_GE(table.getCapacity(), 16);
+    for (int i = 9990; i < 10000; ++i) EXPECT_TRUE(table.find(i, value)) << i;
+
+    // Вставка и удаление на границе не вызывают rehash на каждой операции
+    size_t stable = table.getCapacity();
+    for (int round = 0; round < 100; ++round) {
+        table.insert(-1, 0);
+        table.remove(-1);
+    }
+    EXPECT_EQ(table.getCapacity(), stable);
+}
+
+TEST(CapacityPlanningTest, IncrementalShrink) {
+    ChainingHashTable<int, int> chain;
+    OpenAddressingHashTable<int, int> open;
+    chain.setIncrementalRehash(4);
+    open.setIncrementalRehash(4);
+    chain.setLoadFactors(0.1, 0.9);
+    open.setLoadFactors(0.1, 0.9);
+    for (int i = 0; i < 2000; ++i) {
+        chain.insert(i, i);
+        open.insert(i, i);
+    }
+    for (int i = 0; i < 1990; ++i) {
+        chain.remove(i);
+        open.remove(i);
+    }
+    EXPECT_LT(chain.getCapacity(), 256);
+    EXPECT_LT(open.getCapacity(), 256);
+    int value = 0;
+    for (int i = 1990; i < 2000; ++i) {
+        EXPECT_TRUE(chain.find(i, value));
+        EXPECT_TRUE(open.find(i, value));
+    }
+}
+
+TEST(CapacityPlanningTest, LoadFactorLimits) {
+    // Таблицы с пробированием при пороге от 1 никогда не росли бы
+    RobinHoodHashTable<int, int> robin(8);
+    EXPECT_THROW(robin.setLoadFactors(0.0, 1.5), std::invalid_argument);
+    EXPECT_THROW(robin.setLoadFactors(0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW((OpenAddressingHashTable<int, int>(8, 1.5)), std::invalid_argument);
+    EXPECT_THROW((SwissHashTable<int, int>(8, 1.2)), std::invalid_argument);
+    CuckooHashTable<int, int> cuckoo(8);
+    EXPECT_THROW(cuckoo.setLoadFactors(0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW((ChainingHashTable<int, int>(8, 0.0)), std::invalid_argument);
+
+    // Цепочки вмещают больше элементов, чем ячеек
+    ChainingHashTable<int, int> chain(8);
+    chain.setLoadFactors(0.0, 1.5);
+    for (int i = 0; i < 12; ++i) chain.insert(i, i);
+    EXPECT_EQ(chain.getCapacity(), 8);
+    for (int i = 0; i < 100; ++i) chain.insert(i, i);
+    EXPECT_LE(chain.loadFactor(), 1.5);
+}
+
+TEST(StatsTest, ChainLengthHistogram) {
+    // Тождественный хеш: ключи, кратные 8, собираются в одну цепочку
+    ChainingHashTable<int, int, IdentityHash> table(8, 100.0);
+    for (int i = 0; i < 5; ++i) table.insert(i * 8, i);
+    table.insert(3, 3);
+
+    HashTableStats stats = table.stats();
+    EXPECT_EQ(stats.size, 6);
+    EXPECT_EQ(stats.capacity, 8);
+    EXPECT_EQ(stats.maxLength, 5);
+    ASSERT_EQ(stats.lengthHistogram.size(), 6);
+    EXPECT_EQ(stats.lengthHistogram[0], 6);   // пустые ячейки
+    EXPECT_EQ(stats.lengthHistogram[1], 1);
+    EXPECT_EQ(stats.lengthHistogram[5], 1);
+    EXPECT_EQ(stats.rehashCount, 0);
+    EXPECT_EQ(stats.tombstones, 0);
+}
+
+TEST(StatsTest, ProbeLengthsAndTombstones) {
+    OpenAddressingHashTable<int, int, IdentityHash> table(16);
+    table.insert(0, 0);
+    table.insert(16, 1);    // та же родная ячейка - смещение 1
+    table.insert(32, 2);
+    table.remove(16);
+
+    HashTableStats stats = table.stats();
+    EXPECT_EQ(stats.tombstones, 1);
+    EXPECT_EQ(stats.lengthHistogram[0], 1);
+    EXPECT_GE(stats.maxLength, 1);
+    EXPECT_EQ(stats.lengthHistogram[0] + stats.lengthHistogram[stats.maxLength], 2);
+}
+
+TYPED_TEST(AnyTableTest, Stats) {
+    using Table = TableOf<TypeParam, int, int>;
+    Table table(16);
+    for (int i = 0; i < 1000; ++i) table.insert(i, i);
+    HashTableStats stats = table.stats();
+    size_t counted = 0;
+    for (size_t count : stats.lengthHistogram) counted += count;
+    EXPECT_EQ(stats.size, 1000);
+    EXPECT_DOUBLE_EQ(stats.loadFactor, table.loadFactor());
+    EXPECT_GT(stats.rehashCount, 0);
+    EXPECT_GE(stats.rehashSeconds, 0.0);
+    // Хороший хеш на последовательных ключах - короткие пробы
+    EXPECT_LT(stats.averageLength(), 2.0);
+    // Цепочки считаются по ячейкам, пробы - по ключам
+    EXPECT_TRUE(counted == stats.capacity || counted == stats.size) << counted;
+}
+
+// Гистограмма ведётся вставками и удалениями: в любой момент в ней
+// ровно столько ключей, сколько в таблице
+template<typename Table>
+void checkStatsCounters(Table& table) {
+    std::mt19937 rng(7);
+    for (int op = 0; op < 20000; ++op) {
+        int key = static_cast<int>(rng() % 3000);
+        if (rng() % 3 == 0) table.remove(key);
+        else table.insert(key, op);
+        if (op % 1000 == 0) {
+            HashTableStats stats = table.stats();
+            size_t counted = 0;
+            for (size_t count : stats.lengthHistogram) counted += count;
+            ASSERT_EQ(counted, table.getSize()) << op;
+            if (!stats.lengthHistogram.empty()) {
+                EXPECT_GT(stats.lengthHistogram[stats.maxLength], 0);
+            }
+        }
+    }
+    table.shrinkToFit();
+    HashTableStats stats = table.stats();
+    size_t counted = 0;
+    for (size_t count : stats.lengthHistogram) counted += count;
+    EXPECT_EQ(counted, table.getSize());
+    EXPECT_EQ(stats.tombstones, 0);
+}
+
+TEST(StatsTest, CountersFollowUpdates) {
+    OpenAddressingHashTable<int, int> open(16);
+    open.setLoadFactors(0.2, 0.8);
+    checkStatsCounters(open);
+    OpenAddressingHashTable<int, int> incremental(16);
+    incremental.setIncrementalRehash(8);
+    checkStatsCounters(incremental);
+    OpenAddressingHashTable<int, int> parallel(1 << 17);
+    parallel.setRehashThreads(2);
+    for (int i = 0; i < 1 << 17; ++i) parallel.insert(-i - 1, i);
+    checkStatsCounters(parallel);
+    SwissHashTable<int, int> swiss(16);
+    swiss.setLoadFactors(0.2, 0.8);
+    checkStatsCounters(swiss);
+}
+
+// Метод цепочек считает ячейки, а не ключи: сумма длин по гистограмме
+// равна числу ключей, а без постепенного rehash она совпадает с
+// гистограммой, посчитанной заново по остаткам ключей
+template<typename Table>
+void checkChainCounters(Table& table, bool exact) {
+    std::mt19937 rng(11);
+    for (int op = 0; op < 20000; ++op) {
+        int key = static_cast<int>(rng() % 3000);
+        if (rng() % 3 == 0) table.remove(key);
+        else table.insert(key, op);
+        if (op % 1000 != 0 && op != 19999) continue;
+        HashTableStats stats = table.stats();
+        size_t keys = 0;
+        for (size_t i = 0; i < stats.lengthHistogram.size(); ++i) keys += i * stats.lengthHistogram[i];
+        ASSERT_EQ(keys, table.getSize()) << op;
+        if (!exact) continue;
+        std::vector<size_t> lengths(stats.capacity, 0);
+        table.forEach([&](int k, int) { lengths[static_cast<size_t>(k) % stats.capacity]++; });
+        HashTableStats expected;
+        for (size_t length : lengths) expected.addLength(length);
+        ASSERT_EQ(stats.lengthHistogram, expected.lengthHistogram) << op;
+        ASSERT_EQ(stats.maxLength, expected.maxLength) << op;
+    }
+}
+
+TEST(StatsTest, ChainCountersFollowUpdates) {
+    ChainingHashTable<int, int, IdentityHash> plain(16);
+    plain.setLoadFactors(0.2, 0.8);
+    checkChainCounters(plain, true);
+    plain.shrinkToFit();
+    checkChainCounters(plain, true);
+    ChainingHashTable<int, int> incremental(16);
+    incremental.setIncrementalRehash(4);
+    incremental.setLoadFactors(0.2, 0.8);
+    checkChainCounters(incremental, false);
+}
+
+TEST(StatsTest, RobinHoodMaxProbe) {
+    RobinHoodHashTable<int, int> robin;
+    for (int i = 0; i < 1000; ++i) robin.insert(i, i);
+    EXPECT_EQ(robin.stats().maxLength, robin.maxProbeLength());
+}
+
+TEST(CuckooTest, BasicOperations) {
+    CuckooHashTable<int, std::string> table;
+    table.insert(1, "one");
+    table.insert(2, "two");
+    table.insert(1, "uno");
+
+    std::string value;
+    EXPECT_TRUE(table.find(1, value));
+    EXPECT_EQ(value, "uno");
+    EXPECT_EQ(table.getSize(), 2);
+    EXPECT_TRUE(table.remove(2));
+    EXPECT_FALSE(table.remove(2));
+    EXPECT_FALSE(table.find(2, value));
+
+    testing::internal::CaptureStdout();
+    table.display();
+    EXPECT_NE(testing::internal::GetCapturedStdout().find("uno"), std::string::npos);
+}
+
+TEST(CuckooTest, SustainsHighLoadFactor) {
+    CuckooHashTable<int, int> table(1 << 14, 0.97);
+    size_t capacity = table.getCapacity();
+    int count = static_cast<int>(capacity * 0.95);
+    for (int i = 0; i < count; ++i) table.insert(i, i * 3);
+
+    // 95% заполнения без роста таблицы
+    EXPECT_EQ(table.getCapacity(), capacity);
+    EXPECT_GT(table.loadFactor(), 0.9);
+    EXPECT_LE(table.stashSize(), 4);
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(table.find(i, value)) << i;
+        EXPECT_EQ(value, i * 3);
+    }
+    EXPECT_FALSE(table.find(-1, value));
+
+    // Ключ лежит в одной из двух своих корзин или в тайнике
+    HashTableStats stats = table.stats();
+    EXPECT_LE(stats.maxLength, 2);
+    EXPECT_GT(stats.lengthHistogram[1], 0);
+}
+
+TEST(CuckooTest, GrowthAndRemoval) {
+    CuckooHashTable<int, int> table(8);
+    for (int i = 0; i < 10000; ++i) table.insert(i, i);
+    for (int i = 0; i < 10000; i += 2) EXPECT_TRUE(table.remove(i));
+    EXPECT_EQ(table.getSize(), 5000);
+    int value = 0;
+    for (int i = 0; i < 10000; ++i) EXPECT_EQ(table.find(i, value), i % 2 == 1) << i;
+}
+
+TEST(CuckooTest, DegenerateHashFallsBackToStash) {
+    // Все ключи с одним хешем: две корзины на всех, остальное - в тайнике
+    struct ConstantHash {
+        size_t operator()(int) const { return 42; }
+    };
+    CuckooHashTable<int, int, ConstantHash> table;
+    for (int i = 0; i < 100; ++i) table.insert(i, i);
+    EXPECT_EQ(table.getSize(), 100);
+    EXPECT_GT(table.stashSize(), 4);
+    int value = 0;
+    for (int i = 0; i < 100; ++i) EXPECT_TRUE(table.find(i, value));
+    // По четыре ключа в основной и альтернативной корзинах
+    EXPECT_EQ(table.stats().lengthHistogram, (std::vector<size_t>{4, 4, 92}));
+    EXPECT_TRUE(table.remove(99));
+    EXPECT_FALSE(table.find(99, value));
+
+    // Счётчики stats() ведут вставка, вытеснение и удаление
+    for (int i = 0; i < 60; ++i) table.remove(i);
+    HashTableStats stats = table.stats();
+    EXPECT_EQ(stats.lengthHistogram[0] + stats.lengthHistogram[1] + stats.lengthHistogram[2], table.getSize());
+    EXPECT_EQ(stats.lengthHistogram[2], table.stashSize());
+}
+
+TEST(CuckooTest, TransparentAndPolymorphic) {
+    CuckooHashTable<std::string, int> table;
+    table.insert("alpha", 1);
+    int value = 0;
+    EXPECT_TRUE(table.find(std::string_view("alpha"), value));
+    EXPECT_EQ(*table.lookup("alpha"), 1);
+    EXPECT_TRUE(table.remove("alpha"));
+
+    std::unique_ptr<HashTable<int, int>> erased(new PolymorphicHashTable<CuckooHashTable<int, int>>());
+    erased->insert(5, 50);
+    EXPECT_TRUE(erased->find(5, value));
+    EXPECT_EQ(value, 50);
+}
+
+TYPED_TEST(DynamicTableTest, Iteration) {
+    using Table = TableOf<TypeParam, int, int>;
+    Table table(8);
+    table.setIncrementalRehash(3);
+    std::map<int, int> expected;
+    std::mt19937 gen(11);
+    for (int step = 0; step < 5000; ++step) {
+        int key = static_cast<int>(gen() % 700);
+        if (gen() % 3 == 0) {
+            table.remove(key);
+            expected.erase(key);
+        } else {
+            table.insert(key, step);
+            expected[key] = step;
+        }
+    }
+
+    // Итератор и forEach видят каждую пару ровно один раз, пропуская
+    // пустые, удалённые и уже перенесённые ячейки
+    std::map<int, int> seen;
+    for (auto [key, value] : table) {
+        EXPECT_TRUE(seen.emplace(key, value).second) << key;
+    }
+    EXPECT_EQ(seen, expected);
+
+    std::map<int, int> visited;
+    const Table& view = table;
+    view.forEach([&](const int& key, const int& value) { visited[key] = value; });
+    EXPECT_EQ(visited, expected);
+
+    // Изменение значений через итератор и forEach
+    for (auto it = table.begin(); it != table.end(); ++it) it.value() = -it.key();
+    table.forEach([](const int&, int& value) { value *= 2; });
+    size_t count = 0;
+    for (auto it = view.begin(); it != view.end(); it++, ++count) {
+        EXPECT_EQ(it.value(), -2 * it.key());
+    }
+    EXPECT_EQ(count, table.getSize());
+
+    // Разыменование даёт прокси-пару, поэтому итератор объявлен input;
+    // it-> работает через прокси, а копирование в контейнер - как обычно
+    static_assert(std::is_same<typename std::iterator_traits<typename Table::iterator>::iterator_category,
+                               std::input_iterator_tag>::value, "proxy iterator must be an input iterator");
+    for (auto it = view.begin(); it != view.end(); ++it) EXPECT_EQ(it->second, -2 * it->first);
+    std::vector<std::pair<int, int>> copied(view.begin(), view.end());
+    EXPECT_EQ(copied.size(), table.getSize());
+
+    Table empty;
+    EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(InternedStringsTest, InternOnce) {
+    StringInterner interner;
+    InternedKey a = interner.intern("alpha");
+    InternedKey b = interner.intern(std::string("beta"));
+    EXPECT_EQ(interner.intern(std::string_view("alpha")), a);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(interner.size(), 2);
+    EXPECT_EQ(interner.view(a), "alpha");
+
+    InternedKey found{0};
+    EXPECT_TRUE(interner.lookup("beta", found));
+    EXPECT_EQ(found, b);
+    EXPECT_FALSE(interner.lookup("gamma", found));
+    EXPECT_EQ(interner.size(), 2);
+
+    // Пустая и длинная строки, тексты не двигаются при росте арены
+    InternedKey empty = interner.intern("");
+    std::string big(100000, 'x');
+    InternedKey large = interner.intern(big);
+    std::string_view alphaView = interner.view(a);
+    for (int i = 0; i < 20000; ++i) interner.intern("key-" + std::to_string(i));
+    EXPECT_EQ(interner.view(empty), "");
+    EXPECT_EQ(interner.view(large), big);
+    EXPECT_EQ(alphaView.data(), interner.view(a).data());
+    EXPECT_EQ(interner.view(interner.intern("key-12345")), "key-12345");
+    EXPECT_THROW(interner.view(InternedKey{1u << 30}), std::out_of_range);
+}
+
+TEST(InternedStringsTest, KeysInTables) {
+    StringInterner interner;
+    ChainingHashTable<InternedKey, std::string> chain;
+    OpenAddressingHashTable<InternedKey, int> open;
+    for (int i = 0; i < 500; ++i) {
+        InternedKey key = interner.intern("user:" + std::to_string(i));
+        chain.insert(key, std::to_string(i));
+        open.insert(key, i);
+    }
+
+    InternedKey key{0};
+    ASSERT_TRUE(interner.lookup("user:42", key));
+    std::string text;
+    EXPECT_TRUE(chain.find(key, text));
+    EXPECT_EQ(text, "42");
+    EXPECT_EQ(*open.lookup(key), 42);
+    for (auto [stored, value] : open) EXPECT_EQ(interner.view(stored), "user:" + std::to_string(value));
+
+    testing::internal::CaptureStdout();
+    chain.display();
+    EXPECT_NE(testing::internal::GetCapturedStdout().find("#"), std::string::npos);
+}
+
+TYPED_TEST(DynamicTableTest, BloomFilter) {
+    using Table = TableOf<TypeParam, int, int>;
+    Table table(8);
+    table.setIncrementalRehash(5);
+    for (int i = 0; i < 1000; ++i) table.insert(i, i);
+    // Включение на заполненной таблице учитывает уже лежащие ключи
+    table.enableBloomFilter();
+    EXPECT_TRUE(table.hasBloomFilter());
+    for (int i = 1000; i < 20000; ++i) table.insert(i, i);
+    for (int i = 0; i < 20000; i += 3) EXPECT_TRUE(table.remove(i));
+    // Удаление большей части ключей вызывает перестройку фильтра
+    for (int i = 1; i < 20000; i += 3) EXPECT_TRUE(table.remove(i));
+
+    int value = 0;
+    for (int i = 0; i < 20000; ++i) {
+        bool present = i % 3 == 2;
+        ASSERT_EQ(table.find(i, value), present) << i;
+        if (present) {
+            EXPECT_TRUE(table.mightContain(i));
+        }
+    }
+    EXPECT_FALSE(table.remove(1));
+
+    size_t falsePositives = 0;
+    for (int i = 100000; i < 200000; ++i) falsePositives += table.mightContain(i);
+    EXPECT_LT(falsePositives, 3000);
+
+    table.disableBloomFilter();
+    EXPECT_TRUE(table.mightContain(-5));
+    EXPECT_TRUE(table.find(2, value));
+    EXPECT_THROW(table.enableBloomFilter(0), std::invalid_argument);
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+    LruCache<int, std::string> cache(3);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+    ASSERT_NE(cache.get(1), nullptr);   // 2 становится самым старым
+    cache.put(4, "four");
+
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache.evictions(), 1u);
+
+    std::vector<int> order;
+    cache.forEach([&](int key, const std::string&) { order.push_back(key); });
+    EXPECT_EQ(order, (std::vector<int>{4, 1, 3}));
+
+    std::string value;
+    EXPECT_TRUE(cache.get(3, value));
+    EXPECT_EQ(value, "three");
+    EXPECT_FALSE(cache.get(2, value));
+    EXPECT_EQ(cache.hits(), 2u);
+    EXPECT_EQ(cache.misses(), 1u);
+    EXPECT_DOUBLE_EQ(cache.hitRate(), 2.0 / 3.0);
+
+    EXPECT_TRUE(cache.remove(1));
+    EXPECT_FALSE(cache.remove(1));
+    cache.setCapacity(1);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_THROW(cache.setCapacity(0), std::invalid_argument);
+    EXPECT_THROW((LruCache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(LruCacheTest, ClockGivesSecondChance) {
+    LruCache<int, int> cache(3, EvictionPolicy::CLOCK);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    cache.get(1);
+    cache.put(4, 4);   // 1 помечен и переживает проход, вытесняется 2
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    cache.put(5, 5);   // бит 1 уже сброшен, теперь вытесняется 3
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_EQ(cache.evictions(), 2u);
+}
+
+TEST(LruCacheTest, ByteCapacity) {
+    LruCache<int, std::string, CacheBytes> cache(1024);
+    std::string big(300, 'x');
+    for (int i = 0; i < 10; ++i) EXPECT_TRUE(cache.put(i, big));
+    EXPECT_LE(cache.weight(), cache.capacity());
+    EXPECT_LT(cache.size(), 10u);
+    EXPECT_TRUE(cache.contains(9));
+
+    // Запись тяжелее всей ёмкости не сохраняется и вытесняет старое значение
+    EXPECT_FALSE(cache.put(9, std::string(2000, 'y')));
+    EXPECT_FALSE(cache.contains(9));
+    cache.clear();
+    EXPECT_TRUE(cache.isEmpty());
+    EXPECT_EQ(cache.weight(), 0u);
+}
+
+// Вес считается по хранимым std::string, а не по аргументам const char*;
+// место удалённой записи занимает следующая вставка
+TEST(LruCacheTest, WeighsStoredEntries) {
+    LruCache<std::string, std::string, CacheBytes> cache(4096);
+    const char* value = "value";
+    EXPECT_TRUE(cache.put("key", value));
+    std::string key("key");
+    std::string stored(value);
+    EXPECT_EQ(cache.weight(), cacheBytes(key) + cacheBytes(stored));
+
+    EXPECT_TRUE(cache.put("key", "a longer value that does not fit into the small string buffer"));
+    ASSERT_NE(cache.get("key"), nullptr);
+    EXPECT_EQ(cache.weight(), cacheBytes(key) + cacheBytes(*cache.get("key")));
+
+    for (int i = 0; i < 8; ++i) cache.put(std::to_string(i), "x");
+    EXPECT_TRUE(cache.remove("3"));
+    EXPECT_TRUE(cache.remove("5"));
+    EXPECT_EQ(cache.size(), 7u);
+    EXPECT_FALSE(cache.contains("3"));
+    cache.put("new", "y");
+    EXPECT_EQ(cache.size(), 8u);
+    for (const char* name : {"key", "0", "4", "7", "new"}) EXPECT_TRUE(cache.contains(name));
+    std::string y;
+    EXPECT_TRUE(cache.get("new", y));
+    EXPECT_EQ(y, "y");
+}
+
+// Случайные операции против эталонной модели на std::list
+TEST(LruCacheTest, MatchesReferenceModel) {
+    LruCache<int, int> cache(64);
+    std::list<std::pair<int, int>> model;
+    std::mt19937 gen(11);
+    for (int step = 0; step < 20000; ++step) {
+        int key = static_cast<int>(gen() % 200);
+        auto it = std::find_if(model.begin(), model.end(), [&](const auto& p) { return p.first == key; });
+        switch (gen() % 3) {
+        case 0: {
+            cache.put(key, step);
+            if (it != model.end()) model.erase(it);
+            model.emplace_front(key, step);
+            if (model.size() > 64) model.pop_back();
+            break;
+        }
+        case 1: {
+            int* value = cache.get(key);
+            ASSERT_EQ(value != nullptr, it != model.end()) << step;
+            if (value) {
+                EXPECT_EQ(*value, it->second);
+                model.splice(model.begin(), model, it);
+            }
+            break;
+        }
+        default:
+            EXPECT_EQ(cache.remove(key), it != model.end());
+            if (it != model.end()) model.erase(it);
+        }
+    }
+    std::vector<std::pair<int, int>> order;
+    cache.forEach([&](int key, int value) { order.emplace_back(key, value); });
+    EXPECT_EQ(order, (std::vector<std::pair<int, int>>(model.begin(), model.end())));
+}
+
+TEST(PerfectHashTest, FindsEveryKeyAndRejectsOthers) {
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 20000; ++i) entries.emplace_back(i * 7 + 3, i);
+    PerfectHashTable<int, int> table(entries);
+    EXPECT_EQ(table.getSize(), entries.size());
+
+    int value = 0;
+    for (const auto& [key, expected] : entries) {
+        ASSERT_TRUE(table.find(key, value)) << key;
+        EXPECT_EQ(value, expected);
+    }
+    for (int i = 0; i < 20000; ++i) EXPECT_FALSE(table.contains(i * 7 + 4));
+    // Около 8 бит служебной памяти на ключ сверх самих пар
+    EXPECT_LT(table.memoryUsage(), entries.size() * (sizeof(std::pair<int, int>) + 2));
+
+    PerfectHashTable<int, int> empty({});
+    EXPECT_FALSE(empty.contains(1));
+    EXPECT_THROW((PerfectHashTable<int, int>({{1, 1}, {2, 2}, {1, 3}})), std::invalid_argument);
+}
+
+TEST(PerfectHashTest, StringKeysAndSnapshotOfTable) {
+    OpenAddressingHashTable<std::string, int> source;
+    for (int i = 0; i < 1000; ++i) source.insert("word" + std::to_string(i), i);
+    source.remove("word5");
+    auto table = PerfectHashTable<std::string, int>::fromTable(source);
+    EXPECT_EQ(table.getSize(), 999u);
+
+    ASSERT_NE(table.lookup(std::string_view("word999")), nullptr);
+    EXPECT_EQ(*table.lookup("word999"), 999);
+    EXPECT_FALSE(table.contains("word5"));
+    EXPECT_FALSE(table.contains(std::string("word1000")));
+}
+
+TEST(PerfectHashTest, CompileTimeTable) {
+    static constexpr auto keywords = makeStaticPerfectHash<std::string_view, int>({
+        {"if", 1}, {"else", 2}, {"while", 3}, {"for", 4}, {"return", 5}, {"break", 6},
+        {"continue", 7}, {"switch", 8}, {"case", 9}, {"default", 10}, {"do", 11}, {"goto", 12}});
+    static_assert(keywords.get("while", 0) == 3, "keyword lookup at compile time");
+    static_assert(keywords.get("until", 0) == 0, "missing keyword");
+    static_assert(keywords.contains("goto") && !keywords.contains("got"), "contains at compile time");
+    EXPECT_EQ(keywords.getSize(), 12u);
+
+    int value = 0;
+    EXPECT_TRUE(keywords.find("default", value));
+    EXPECT_EQ(value, 10);
+
+    constexpr auto codes = makeStaticPerfectHash<int, char>({{200, 'o'}, {404, 'n'}, {500, 'e'}});
+    static_assert(codes.get(404, '?') == 'n' && codes.get(403, '?') == '?', "integer keys");
+}
+
+TYPED_TEST(DynamicTableTest, Expiry) {
+    using Table = ExpiringHashTable<int, std::string, TableOf<TypeParam, int, ExpiringValue<std::string>>>;
+    Table table;
+    table.insert(1, "short", 5);
+    table.insert(2, "forever");
+    table.insert(3, "long", 70000);   // через два уровня колеса
+    table.insert(4, "now", 0);   // уже истекла: не вставляется
+    EXPECT_EQ(table.getSize(), 3u);
+
+    std::string value;
+    EXPECT_FALSE(table.find(4, value));
+    EXPECT_TRUE(table.find(1, value));
+    uint64_t ttl = 0;
+    EXPECT_TRUE(table.timeToLive(1, ttl));
+    EXPECT_EQ(ttl, 5u);
+
+    EXPECT_EQ(table.advance(4), 0u);
+    EXPECT_TRUE(table.contains(1));
+    EXPECT_EQ(table.advance(), 1u);
+    EXPECT_FALSE(table.contains(1));
+    EXPECT_EQ(table.getSize(), 2u);
+
+    // Перезапись продлевает срок; старый таймер срабатывает впустую
+    table.insert(5, "old", 10);
+    table.insert(5, "new", 100);
+    EXPECT_EQ(table.advance(50), 0u);
+    EXPECT_TRUE(table.find(5, value));
+    EXPECT_EQ(value, "new");
+    EXPECT_TRUE(table.remove(5));
+
+    // Наступивший срок стирает прежнее значение ключа
+    table.insert(7, "seven", 10);
+    table.insertUntil(7, "late", table.now());
+    EXPECT_FALSE(table.contains(7));
+    EXPECT_EQ(table.getSize(), 2u);
+    EXPECT_FALSE(table.remove(7));
+
+    EXPECT_EQ(table.advance(69990 - 55), 0u);
+    EXPECT_TRUE(table.contains(3));
+    EXPECT_EQ(table.advance(10), 1u);
+    EXPECT_FALSE(table.contains(3));
+    EXPECT_TRUE(table.timeToLive(2, ttl));
+    EXPECT_EQ(ttl, NEVER_EXPIRES);
+    EXPECT_EQ(table.pendingTimers(), 0u);
+    EXPECT_EQ(table.expired(), 2u);
+
+    // Без таймеров часы перескакивают, не перебирая тики
+    table.advance(uint64_t(1) << 40);
+    EXPECT_EQ(table.now(), 70000u + (uint64_t(1) << 40));
+    table.insert(6, "far", uint64_t(1) << 33);   // за горизонтом колеса
+    table.advance((uint64_t(1) << 33) - 1);
+    EXPECT_TRUE(table.contains(6));
+    EXPECT_EQ(table.advance(), 1u);
+    EXPECT_EQ(table.getSize(), 1u);
+}
+
+// Случайные сроки против эталона: после каждого тика в таблице ровно
+// живые записи
+TEST(ExpiryTest, MatchesReferenceModel) {
+    ExpiringOpenAddressingHashTable<int, int> table;
+    std::map<int, uint64_t> model;   // ключ -> тик истечения
+    std::mt19937 gen(17);
+    for (int step = 0; step < 3000; ++step) {
+        for (int i = 0; i < 20; ++i) {
+            int key = static_cast<int>(gen() % 5000);
+            uint64_t ttl = 1 + (gen() % 4 ? gen() % 300 : gen() % 100000);
+            table.insert(key, step, ttl);
+            model[key] = table.now() + ttl;
+        }
+        table.advance(gen() % 40);
+        for (auto it = model.begin(); it != model.end();) {
+            it = it->second <= table.now() ? model.erase(it) : std::next(it);
+        }
+        ASSERT_EQ(table.getSize(), model.size()) << step;
+    }
+    size_t alive = 0;
+    table.forEach([&](int key, int) {
+        EXPECT_TRUE(model.count(key));
+        alive++;
+    });
+    EXPECT_EQ(alive, model.size());
+}
+
+TYPED_TEST(DynamicTableTest, InsertBulk) {
+    using Table = TableOf<TypeParam, int, int>;
+    Table table(8);
+    table.setIncrementalRehash(4);
+    table.enableBloomFilter();
+    table.insert(-1, -1);
+    table.insert(5, 0);
+
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 10000; ++i) entries.emplace_back(i, i);
+    entries.emplace_back(7, 700);   // повторный ключ в пакете: побеждает последний
+    std::map<int, int> source(entries.begin(), entries.begin() + 10);
+
+    EXPECT_EQ(table.insertBulk(entries.begin(), entries.end()), 9999u);   // 5 уже был
+    EXPECT_EQ(table.insertBulk(source.begin(), source.end()), 0u);        // любые прямые итераторы
+    EXPECT_EQ(table.getSize(), 10001u);
+    EXPECT_LE(table.loadFactor(), table.maxLoadFactor());
+
+    int value = 0;
+    EXPECT_TRUE(table.find(-1, value));
+    EXPECT_TRUE(table.find(5, value));
+    EXPECT_EQ(value, 5);
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(table.find(i, value)) << i;
+        EXPECT_EQ(value, i == 7 ? 7 : i);   // второй пакет вернул 7 из source
+    }
+    EXPECT_EQ(table.insertBulk(entries.end(), entries.end()), 0u);
+    EXPECT_TRUE(table.remove(9999));
+    EXPECT_FALSE(table.find(9999, value));
+}
+
+TEST(InsertBulkTest, DuplicatesMatchInsert) {
+    std::vector<std::pair<std::string, int>> entries = {{"a", 1}, {"b", 2}, {"a", 3}, {"c", 4}, {"b", 5}};
+    ChainingHashTable<std::string, int> bulk, single;
+    bulk.insertBulk(entries.begin(), entries.end());
+    for (const auto& [key, value] : entries) single.insert(key, value);
+
+    int a = 0, b = 0;
+    for (const char* key : {"a", "b", "c"}) {
+        EXPECT_TRUE(bulk.find(key, a));
+        EXPECT_TRUE(single.find(key, b));
+        EXPECT_EQ(a, b) << key;
+    }
+    EXPECT_EQ(bulk.getSize(), single.getSize());
+}
+
+TYPED_TEST(DynamicTableTest, ParallelRehash) {
+    using Table = TableOf<TypeParam, std::string, int>;
+    Table table;
+    table.setRehashThreads(4);
+    EXPECT_EQ(table.getRehashThreads(), 4u);
+    const int n = 300000;
+    for (int i = 0; i < n; ++i) table.insert(std::to_string(i), i);
+    table.reserve(3 * n);
+    for (int i = 0; i < n; i += 2) EXPECT_TRUE(table.remove(std::to_string(i)));
+    table.rehash(0);   // сжатие тоже параллельное
+
+    int value = 0;
+    for (int i = 0; i < n; ++i) {
+        bool present = i % 2 == 1;
+        ASSERT_EQ(table.find(std::to_string(i), value), present) << i;
+        if (present) {
+            EXPECT_EQ(value, i);
+        }
+    }
+    size_t visited = 0;
+    table.forEach([&](const std::string&, int) { visited++; });
+    EXPECT_EQ(visited, table.getSize());
+    EXPECT_EQ(table.getSize(), static_cast<size_t>(n / 2));
+
+    table.setRehashThreads(0);
+    EXPECT_GE(table.getRehashThreads(), 1u);
+}
+
+// Chaining перевязывает узлы в потоках только от PARALLEL_RELINK_MIN записей
+TEST(ParallelRehashTest, ChainingRelinkAboveThreshold) {
+    ChainingHashTable<int, int> table;
+    table.setRehashThreads(4);
+    const int n = static_cast<int>(PARALLEL_RELINK_MIN) + 1000;
+    for (int i = 0; i < n; ++i) table.insert(i * 7, i);
+    table.reserve(2 * static_cast<size_t>(n));
+    EXPECT_EQ(table.getSize(), static_cast<size_t>(n));
+    int value = 0;
+    for (int i = 0; i < n; ++i) {
+        ASSERT_TRUE(table.find(i * 7, value)) << i;
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(table.find(1, value));
+}
+
+TEST(LatencyHistogramTest, BucketsAndPercentiles) {
+    for (uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, ~0ull}) {
+        size_t bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKETS);
+        EXPECT_LE(LatencyHistogram::lowerBound(bucket), value);
+        EXPECT_GE(LatencyHistogram::upperBound(bucket), value);
+        // Ширина корзины - не больше 1/16 её нижней границы
+        EXPECT_LE(LatencyHistogram::upperBound(bucket) - LatencyHistogram::lowerBound(bucket),
+                  LatencyHistogram::lowerBound(bucket) / 16);
+    }
+
+    LatencyHistogram first, second;
+    for (uint64_t v = 1; v <= 1000; ++v) first.record(v * 100);
+    second.record(5000000, 10);
+    EXPECT_NEAR(static_cast<double>(first.percentile(50)), 50000.0, 50000.0 / 16);
+    EXPECT_NEAR(static_cast<double>(first.percentile(99)), 99000.0, 99000.0 / 16);
+    EXPECT_DOUBLE_EQ(first.mean(), 50050.0);
+
+    first.merge(second);
+    EXPECT_EQ(first.count(), 1010u);
+    EXPECT_GE(first.maxValue(), 5000000u);
+    EXPECT_LE(first.minValue(), 100u);
+
+    std::ostringstream csv;
+    second.exportCsv(csv);
+    size_t bucket = LatencyHistogram::bucketOf(5000000);
+    EXPECT_EQ(csv.str(), "low,high,count\n" + std::to_string(LatencyHistogram::lowerBound(bucket)) + "," +
+                             std::to_string(LatencyHistogram::upperBound(bucket)) + ",10\n");
+    second.reset();
+    EXPECT_EQ(second.count(), 0u);
+    EXPECT_EQ(second.percentile(50), 0u);
+}
+
+TEST(LatencyHistogramTest, RecorderMergesThreads) {
+    LatencyRecorder recorder;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&recorder, t] {
+            for (int i = 0; i < 10000; ++i) recorder.record(HashOp::FIND, 100 + t);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    LatencyHistogram finds = recorder.snapshot(HashOp::FIND);
+    EXPECT_EQ(finds.count(), 40000u);
+    EXPECT_DOUBLE_EQ(finds.mean(), 101.5);
+    EXPECT_EQ(recorder.snapshot(HashOp::INSERT).count(), 0u);
+    recorder.reset();
+    EXPECT_EQ(recorder.snapshot(HashOp::FIND).count(), 0u);
+}
+
+// Копий счётчиков не больше MAX_SHARDS, сколько бы потоков ни писало
+TEST(LatencyHistogramTest, RecorderShardsAreBounded) {
+    LatencyRecorder recorder;
+    EXPECT_EQ(recorder.shardCount(), 0u);
+    const size_t threads = 3 * LatencyRecorder::MAX_SHARDS;
+    for (size_t t = 0; t < threads; ++t) {
+        std::thread([&recorder] { recorder.record(HashOp::INSERT, 10); }).join();
+    }
+    EXPECT_EQ(recorder.shardCount(), LatencyRecorder::MAX_SHARDS);
+    EXPECT_EQ(recorder.snapshot(HashOp::INSERT).count(), threads);
+
+    LatencyRecorder copy(recorder);
+    EXPECT_EQ(copy.shardCount(), 0u);
+}
+
+// Без HASHTABLE_LATENCY операции не замеряются и рекордер не выделяет
+// копий счётчиков; замеры включены в отдельной цели latencyTests.cpp
+TEST(LatencyHistogramTest, UninstrumentedTable) {
+    std::unique_ptr<HashTable<int, int>> table(new PolymorphicHashTable<OpenAddressingHashTable<int, int>>());
+    ChainingHashTable<int, int> chain;
+    int value = 0;
+    for (int i = 0; i < 1000; ++i) {
+        table->insert(i, i);
+        chain.insert(i, i);
+    }
+    EXPECT_TRUE(table->find(7, value));
+    EXPECT_TRUE(chain.remove(7));
+    for (HashOp op : {HashOp::INSERT, HashOp::FIND, HashOp::REMOVE}) {
+        EXPECT_EQ(table->latencyHistogram(op).count(), 0u);
+        EXPECT_EQ(chain.latencyHistogram(op).count(), 0u);
+    }
+}
+
 //Копирование
 TEST(CopyConstructorTest, ForceEntryCopy) {
     OpenAddressingHashTable<int, std::string> t1;
@@ -404,9 +2283,9 @@ TEST(CopyConstructorTest, ForceEntryCopy) {
 
 
 TEST(GeneralCoverage, VirtualDestructors) {
-    HashTable<int, std::string>* ptr = new ChainingHashTable<int, std::string>();
+    HashTable<int, std::string>* ptr = new PolymorphicHashTable<ChainingHashTable<int, std::string>>();
     delete ptr; // ~HashTable()
-    ptr = new OpenAddressingHashTable<int, std::string>();
+    ptr = new PolymorphicHashTable<OpenAddressingHashTable<int, std::string>>();
     delete ptr; 
 }
 
@@ -439,7 +2318,7 @@ TEST(GeneralCoverage, DisplayAndMeasureTime) {
 TEST(FinalCoverage, FixVirtualDestructor) {
     // Создаем объект дочернего класса, но сохраняем в указатель базового
     // Используем именно типы <int, std::string>, которые указаны в ошибке
-    HashTable<int, std::string>* table = new ChainingHashTable<int, std::string>();
+    HashTable<int, std::string>* table = new PolymorphicHashTable<ChainingHashTable<int, std::string>>();
     
     // Вставляем что-нибудь (чтобы не было пусто)
     table->insert(1, "test");
@@ -450,17 +2329,17 @@ TEST(FinalCoverage, FixVirtualDestructor) {
 }
 
 TEST(FinalCoverage, FixVirtualDestructorOA) {
-    HashTable<int, std::string>* table = new OpenAddressingHashTable<int, std::string>();
+    HashTable<int, std::string>* table = new PolymorphicHashTable<OpenAddressingHashTable<int, std::string>>();
     table->insert(1, "test");
     delete table; // Закрывает второй деструктор
 }
 
 TEST(FinalCoverage, DeleteThroughBase) {
     // Создаем именно ту специализацию, на которую ругается lcov: <int, string>
-    HashTable<int, std::string>* t1 = new ChainingHashTable<int, std::string>();
+    HashTable<int, std::string>* t1 = new PolymorphicHashTable<ChainingHashTable<int, std::string>>();
     delete t1; // Вызывает тот самый deleting destructor
 
-    HashTable<int, std::string>* t2 = new OpenAddressingHashTable<int, std::string>();
+    HashTable<int, std::string>* t2 = new PolymorphicHashTable<OpenAddressingHashTable<int, std::string>>();
     delete t2; // Закрывает его для второй таблицы
 }
 
@@ -563,6 +2442,32 @@ TEST(SetTest, RehashInternal) {
 }
 
 // Тест алгоритма разбиения (Partition)
+TEST(SetTest, CapacityPlanning) {
+    Set s(11);
+    s.reserve(1000);
+    int reserved = s.capacity();
+    for (int i = 0; i < 1000; ++i) s.insert(i);
+    EXPECT_EQ(s.capacity(), reserved);
+
+    for (int i = 0; i < 990; ++i) s.remove(i);
+    EXPECT_EQ(s.capacity(), reserved);
+    s.shrinkToFit();
+    EXPECT_LT(s.capacity(), 20);
+    EXPECT_TRUE(s.contains(995));
+    s.rehash(500);
+    EXPECT_EQ(s.capacity(), 500);
+
+    EXPECT_THROW(s.setLoadFactors(0.4, 0.7), std::invalid_argument);
+    s.setLoadFactors(0.1, 0.7);
+    for (int i = 0; i < 5000; ++i) s.insert(i);
+    int grown = s.capacity();
+    for (int i = 0; i < 4990; ++i) s.remove(i);
+    EXPECT_LT(s.capacity(), grown / 8);
+    EXPECT_GE(s.capacity(), 11);
+    EXPECT_EQ(s.size(), 10);
+    EXPECT_TRUE(s.contains(4999));
+}
+
 TEST(SetTest, PartitionAlgorithm) {
     Set s;
     // Множество {1, 2, 3, 4, 6}